@@ -107,7 +107,7 @@ struct BoundedBuffer
       throw std::logic_error{"empty BoundedBuffer"};
       }
 
-    m_first = (m_first + 1) % Size;
+    m_first = wrap(m_first + 1);
     --m_size;
     }
 
@@ -125,12 +125,17 @@ struct BoundedBuffer
   private:
     size_type back_index() const noexcept
       {
-      return (m_first + m_size - 1) % Size;
+      return wrap(m_first + m_size - 1);
       }
 
     size_type push_index() noexcept
       {
-      return (m_first + m_size++) % Size;
+      return wrap(m_first + m_size++);
+      }
+
+    static constexpr size_type wrap(size_type const position) noexcept
+      {
+      return !(Size & (Size - 1)) ? position & (Size - 1) : position < Size ? position : position - Size;
       }
 
     size_type m_first{};
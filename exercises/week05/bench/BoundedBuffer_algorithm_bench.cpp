@@ -0,0 +1,144 @@
+#include "BoundedBuffer.h"
+#include "BoundedBufferAlgorithm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace
+  {
+  constexpr std::size_t elements{1 << 16};
+
+  /*
+   * The ring wrapped once, so every traversal crosses the end of the storage in the middle.
+   */
+  auto make_wrapped()
+    {
+    BoundedBuffer<unsigned> buffer{elements};
+
+    for(std::size_t element{}; element < elements / 2; ++element)
+      {
+      buffer.push(0);
+      }
+
+    for(std::size_t element{}; element < elements; ++element)
+      {
+      if(buffer.full())
+        {
+        buffer.pop();
+        }
+
+      buffer.push(unsigned(element % 1000));
+      }
+
+    return buffer;
+    }
+
+  /*
+   * Runs the operation often enough to take a measurable time and reports nanoseconds per element. The operation
+   * returns a value that goes into a checksum, so the compiler cannot drop it.
+   */
+  template<typename OperationType>
+  auto measure(std::size_t const rounds, OperationType operation)
+    {
+    auto checksum = std::size_t{};
+    auto const start = std::chrono::steady_clock::now();
+
+    for(std::size_t round{}; round < rounds; ++round)
+      {
+      checksum += operation();
+      }
+
+    auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return std::make_pair(elapsed / (rounds * elements), checksum);
+    }
+
+  template<typename IteratorOperation, typename SegmentedOperation>
+  auto compare(std::string const & name, std::size_t const rounds, IteratorOperation iterators, SegmentedOperation segments)
+    {
+    auto const viaIterators = measure(rounds, iterators);
+    auto const viaSegments = measure(rounds, segments);
+
+    if(viaIterators.second != viaSegments.second)
+      {
+      std::cerr << name << ": checksum mismatch\n";
+      std::exit(EXIT_FAILURE);
+      }
+
+    std::cout << std::left << std::setw(12) << name
+              << std::right << std::setw(14) << std::fixed << std::setprecision(3) << viaIterators.first
+              << std::setw(14) << viaSegments.first
+              << std::setw(10) << std::setprecision(2) << viaIterators.first / viaSegments.first << '\n';
+    }
+  }
+
+int main(int argc, char const * argv[])
+  {
+  auto const rounds = argc > 1 ? std::stoul(argv[1]) : 2000ul;
+  auto buffer = make_wrapped();
+  auto const other = buffer;
+  auto target = std::vector<unsigned>(elements);
+
+  /*
+   * Read through volatile pointers in every round, otherwise the compiler hoists the read-only algorithms out of
+   * the measurement loop.
+   */
+  auto * volatile subject = &buffer;
+  auto const * volatile reference = &other;
+
+  std::cout << std::left << std::setw(12) << "algorithm"
+            << std::right << std::setw(14) << "iterator ns"
+            << std::setw(14) << "segment ns"
+            << std::setw(10) << "speedup" << '\n';
+
+  compare("copy", rounds, [&]{
+    std::copy(buffer.begin(), buffer.end(), target.begin());
+    return target[elements / 3];
+  }, [&]{
+    segmented::copy(buffer, target.begin());
+    return target[elements / 3];
+  });
+
+  compare("fill", rounds, [&]{
+    std::fill(buffer.begin(), buffer.end(), 1000u);
+    return buffer.back();
+  }, [&]{
+    segmented::fill(buffer, 1000u);
+    return buffer.back();
+  });
+
+  buffer = other;
+
+  compare("find", rounds, [&]{
+    auto & source = *subject;
+    return std::size_t(std::find(source.begin(), source.end(), 1000u) - source.begin());
+  }, [&]{
+    auto & source = *subject;
+    return std::size_t(segmented::find(source, 1000u) - source.begin());
+  });
+
+  compare("accumulate", rounds, [&]{
+    return std::accumulate(subject->begin(), subject->end(), std::size_t{});
+  }, [&]{
+    return segmented::accumulate(*subject, std::size_t{});
+  });
+
+  compare("transform", rounds, [&]{
+    std::transform(buffer.begin(), buffer.end(), target.begin(), [](unsigned element){ return 3 * element + 1; });
+    return target[elements / 3];
+  }, [&]{
+    segmented::transform(buffer, target.begin(), [](unsigned element){ return 3 * element + 1; });
+    return target[elements / 3];
+  });
+
+  compare("equal", rounds, [&]{
+    return std::size_t(std::equal(subject->begin(), subject->end(), reference->begin()));
+  }, [&]{
+    return std::size_t(segmented::equal(*subject, *reference));
+  });
+  }
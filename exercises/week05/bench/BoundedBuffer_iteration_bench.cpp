@@ -0,0 +1,99 @@
+#include "BoundedBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+  {
+  template<typename IteratorPolicy>
+  using buffer = BoundedBuffer<unsigned, std::allocator<unsigned>, IteratorPolicy>;
+
+  /*
+   * Half of the elements are pushed after the ring wrapped, so the traversal crosses the end of the storage once.
+   */
+  template<typename BufferType>
+  auto make_wrapped(std::size_t const capacity)
+    {
+    BufferType buffer{capacity};
+
+    for(std::size_t element{}; element < capacity / 2; ++element)
+      {
+      buffer.push(0);
+      }
+
+    for(std::size_t element{}; element < capacity; ++element)
+      {
+      if(buffer.full())
+        {
+        buffer.pop();
+        }
+
+      buffer.push(unsigned(element));
+      }
+
+    return buffer;
+    }
+
+  /*
+   * Sums all elements with a range-for loop and reports nanoseconds per element.
+   */
+  template<typename RangeType>
+  auto measure(RangeType const & range, std::size_t const elements, std::size_t const rounds)
+    {
+    auto checksum = unsigned{};
+    auto const start = std::chrono::steady_clock::now();
+
+    for(std::size_t round{}; round < rounds; ++round)
+      {
+      for(auto const element : range)
+        {
+        checksum += element;
+        }
+      }
+
+    auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    if(checksum != unsigned(rounds * (elements * (elements - 1) / 2)))
+      {
+      std::cerr << "checksum mismatch\n";
+      std::exit(EXIT_FAILURE);
+      }
+
+    return elapsed / (rounds * elements);
+    }
+  }
+
+int main(int argc, char const * argv[])
+  {
+  auto const totalElements = argc > 1 ? std::stoul(argv[1]) : 1ul << 28;
+
+  std::cout << std::right << std::setw(10) << "elements"
+            << std::setw(14) << "checked ns"
+            << std::setw(14) << "unchecked ns"
+            << std::setw(14) << "vector ns"
+            << std::setw(10) << "speedup" << '\n';
+
+  for(auto const elements : {1ul << 10, 1ul << 16, 1ul << 22})
+    {
+    auto const rounds = std::max(1ul, totalElements / elements);
+    auto const checkedBuffer = make_wrapped<buffer<buffer_iterator_policy::checked>>(elements);
+    auto const uncheckedBuffer = make_wrapped<buffer<buffer_iterator_policy::unchecked>>(elements);
+    auto const contiguous = std::vector<unsigned>(uncheckedBuffer.begin(), uncheckedBuffer.end());
+
+    auto const checked = measure(checkedBuffer, elements, rounds);
+    auto const unchecked = measure(uncheckedBuffer, elements, rounds);
+    auto const vector = measure(contiguous, elements, rounds);
+
+    std::cout << std::setw(10) << elements
+              << std::setw(14) << std::fixed << std::setprecision(3) << checked
+              << std::setw(14) << unchecked
+              << std::setw(14) << vector
+              << std::setw(10) << std::setprecision(2) << checked / unchecked << '\n';
+    }
+  }
@@ -2,14 +2,100 @@
 #define __FMO__BOUNDED_BUFFER
 
 #include <boost/operators.hpp>
+#include <boost/range/iterator_range.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
 
-template<typename ValueType>
+namespace buffer_iterator_policy
+  {
+  /**
+   * Every iterator operation validates its position and operands and throws on misuse.
+   */
+  struct checked
+    {
+    static constexpr bool checking{true};
+    };
+
+  /**
+   * No validation at all, misusing an iterator is undefined behavior like with the standard containers. The
+   * iterator operations become noexcept and reduce to plain index arithmetic.
+   */
+  struct unchecked
+    {
+    static constexpr bool checking{false};
+    };
+
+  /**
+   * Checked in debug builds, unchecked once NDEBUG is defined.
+   */
+#ifdef NDEBUG
+  using debug_checked = unchecked;
+#else
+  using debug_checked = checked;
+#endif
+  }
+
+namespace buffer_detail
+  {
+  template<typename...>
+  using void_t = void;
+
+  template<typename AllocatorType, typename = void>
+  struct has_construct : std::false_type
+    {
+
+    };
+
+  template<typename AllocatorType>
+  struct has_construct<AllocatorType, void_t<decltype(std::declval<AllocatorType &>().construct(
+                                        std::declval<typename AllocatorType::value_type *>(),
+                                        std::declval<typename AllocatorType::value_type const &>()))>> : std::true_type
+    {
+
+    };
+
+  template<typename AllocatorType, typename = void>
+  struct has_destroy : std::false_type
+    {
+
+    };
+
+  template<typename AllocatorType>
+  struct has_destroy<AllocatorType, void_t<decltype(std::declval<AllocatorType &>().destroy(
+                                      std::declval<typename AllocatorType::value_type *>()))>> : std::true_type
+    {
+
+    };
+
+  /**
+   * Whether the allocator builds elements with placement new and destroys them with their destructor, so memcpy
+   * may replace the construction of trivially copyable elements and trivial destructors may be skipped. The
+   * construct() and destroy() of std::allocator, which it declares up to C++17, do exactly that.
+   */
+  template<typename AllocatorType>
+  using plain_construction = std::integral_constant<bool,
+                               std::is_same<AllocatorType, std::allocator<typename AllocatorType::value_type>>::value ||
+                               !(has_construct<AllocatorType>::value || has_destroy<AllocatorType>::value)>;
+  }
+
+/**
+ * The storage comes from AllocatorType, so a buffer can live in an arena or any other memory resource, and the
+ * elements are built and destroyed through it. Like the standard containers, the buffer keeps its allocator on
+ * swap, copy and move assignment unless the allocator asks to be propagated. Move assignment between buffers with
+ * different allocators that do not propagate moves the elements one by one.
+ */
+template<typename ValueType,
+         typename AllocatorType = std::allocator<ValueType>,
+         typename IteratorPolicy = buffer_iterator_policy::checked>
 struct BoundedBuffer
   {
+  static constexpr bool __checking = IteratorPolicy::checking;
 
   template<typename BufferType>
   struct buffer_iterator : boost::random_access_iterator_helper<buffer_iterator<BufferType>, typename BufferType::value_type>
@@ -42,13 +128,13 @@ struct BoundedBuffer
       return m_buffer == other.m_buffer && m_index == other.m_index;
       }
 
-    auto operator<(buffer_iterator const & other) const
+    auto operator<(buffer_iterator const & other) const noexcept(!__checking)
       {
       throw_on_different_buffer(other);
       return m_index < other.m_index;
       }
 
-    decltype(auto) operator++()
+    decltype(auto) operator++() noexcept(!__checking)
       {
       throw_on_out_of_range(1);
       ++m_index;
@@ -56,7 +142,7 @@ struct BoundedBuffer
       return *this;
       }
 
-    decltype(auto) operator--()
+    decltype(auto) operator--() noexcept(!__checking)
       {
       throw_on_out_of_range(-1);
       --m_index;
@@ -64,7 +150,7 @@ struct BoundedBuffer
       return *this;
       }
 
-    decltype(auto) operator+=(difference_type const offset)
+    decltype(auto) operator+=(difference_type const offset) noexcept(!__checking)
       {
       throw_on_out_of_range(offset);
       m_index += offset;
@@ -72,19 +158,19 @@ struct BoundedBuffer
       return *this;
       }
 
-    decltype(auto) operator-=(difference_type const offset)
+    decltype(auto) operator-=(difference_type const offset) noexcept(!__checking)
       {
       return (*this) += -offset;
       }
 
-    decltype(auto) operator-(buffer_iterator const & other) const
+    decltype(auto) operator-(buffer_iterator const & other) const noexcept(!__checking)
       {
       throw_on_different_buffer(other);
 
       return difference_type(m_index) - difference_type(other.m_index);
       }
 
-    decltype(auto) operator*() const
+    decltype(auto) operator*() const noexcept(!__checking)
       {
       throw_on_invalid_position();
 
@@ -99,7 +185,7 @@ struct BoundedBuffer
         {
         auto newIndex = difference_type(m_index) + offset;
 
-        if(newIndex < 0 || newIndex > difference_type(m_buffer->size()))
+        if(__checking && (newIndex < 0 || newIndex > difference_type(m_buffer->size())))
           {
           throw std::out_of_range{"Iterator out of range"};
           }
@@ -107,7 +193,7 @@ struct BoundedBuffer
 
       auto throw_on_invalid_position() const
         {
-        if(m_index >= m_buffer->size())
+        if(__checking && m_index >= m_buffer->size())
           {
           throw std::out_of_range{"Invalid iterator access - out of bounds"};
           }
@@ -115,7 +201,7 @@ struct BoundedBuffer
 
       auto throw_on_different_buffer(buffer_iterator const & other) const
         {
-        if(m_buffer != other.m_buffer)
+        if(__checking && m_buffer != other.m_buffer)
           {
           throw std::logic_error{"Iterators in binary expression are created from different buffers!"};
           }
@@ -130,32 +216,69 @@ struct BoundedBuffer
   using pointer         = value_type *;
   using const_pointer   = value_type const *;
   using size_type       = std::size_t;
+  using allocator_type  = AllocatorType;
   using iterator        = buffer_iterator<BoundedBuffer>;
   using const_iterator  = buffer_iterator<BoundedBuffer const>;
 
-  BoundedBuffer(size_type const size)
+  using difference_type = std::ptrdiff_t;
+  using segment         = boost::iterator_range<pointer>;
+  using const_segment   = boost::iterator_range<const_pointer>;
+
+  using __allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<value_type>;
+  using __allocator_traits = std::allocator_traits<__allocator>;
+
+  BoundedBuffer(size_type const size, allocator_type const & allocator = allocator_type{})
     : m_maximumSize{size ? size : throw std::invalid_argument{"Tried to allocate BoundedBuffer of size 0"}},
-      m_data{new char[size * sizeof(ValueType)]}
+      m_allocator{allocator},
+      m_data{__allocator_traits::allocate(m_allocator, size)}
     {
 
     }
 
   BoundedBuffer(BoundedBuffer const & other)
-    : BoundedBuffer{other.m_maximumSize}
+    : BoundedBuffer{other, __allocator_traits::select_on_container_copy_construction(other.m_allocator)}
+    {
+
+    }
+
+  BoundedBuffer(BoundedBuffer const & other, allocator_type const & allocator)
+    : BoundedBuffer{other.m_maximumSize, allocator}
     {
     copy(other);
     }
 
   BoundedBuffer(BoundedBuffer && other) noexcept
+    : m_allocator{other.m_allocator}
     {
     swap(other);
     }
 
+  /**
+   * Moves the elements one by one into storage from allocator.
+   */
+  BoundedBuffer(BoundedBuffer && other, allocator_type const & allocator)
+    : BoundedBuffer{other.m_maximumSize, allocator}
+    {
+    auto const head = other.first_segment();
+    auto const tail = other.second_segment();
+
+    push_back_range(std::make_move_iterator(head.begin()), std::make_move_iterator(head.end()));
+    push_back_range(std::make_move_iterator(tail.begin()), std::make_move_iterator(tail.end()));
+    }
+
   ~BoundedBuffer()
     {
     clear();
 
-    delete[](m_data);
+    if(m_data)
+      {
+      __allocator_traits::deallocate(m_allocator, m_data, m_maximumSize);
+      }
+    }
+
+  auto get_allocator() const
+    {
+    return allocator_type{m_allocator};
     }
 
   auto empty() const noexcept
@@ -201,13 +324,16 @@ struct BoundedBuffer
     {
     throw_if_full();
 
-    ::new (ptr() + push_index()) value_type{elem};
+    __allocator_traits::construct(m_allocator, ptr() + to_buffer_index(m_size), elem);
+    ++m_size;
     }
 
   auto push(value_type && elem)
     {
     throw_if_full();
-    ::new (ptr() + push_index()) value_type{std::move(elem)};
+
+    __allocator_traits::construct(m_allocator, ptr() + to_buffer_index(m_size), std::move(elem));
+    ++m_size;
     }
 
   auto pop()
@@ -216,28 +342,86 @@ struct BoundedBuffer
     do_pop();
     }
 
+  /**
+   * Appends all elements of [first, last) or, if they do not fit, none of them. The elements are constructed in
+   * at most two runs, trivially copyable elements from a pointer range with one memcpy per run. If constructing
+   * an element throws, the buffer is left unchanged.
+   */
+  template<typename ForwardIterator>
+  auto push_back_range(ForwardIterator first, ForwardIterator const last)
+    {
+    auto const count = size_type(std::distance(first, last));
+    if(count > m_maximumSize - m_size) throw std::logic_error{"Not enough free slots in BoundedBuffer"};
+
+    auto const head = first_free_segment();
+    auto const middle = std::next(first, difference_type(std::min(count, size_type(head.size()))));
+    auto const headEnd = construct_run(first, middle, head.begin());
+
+    try
+      {
+      construct_run(middle, last, ptr());
+      }
+    catch(...)
+      {
+      destroy_run(head.begin(), headEnd);
+      throw;
+      }
+
+    m_size += count;
+    }
+
+  /**
+   * Removes the count front elements. Trivially destructible elements are dropped without touching them.
+   */
+  auto pop_front_n(size_type const count)
+    {
+    if(count > m_size) throw std::logic_error{"Tried to pop more elements than BoundedBuffer holds"};
+
+    drop_front(count);
+    }
+
+  /**
+   * Moves the count front elements to target before removing them, trivially copyable elements with one memcpy
+   * per segment if target is a pointer.
+   */
+  template<typename OutputIterator>
+  auto pop_front_n(size_type const count, OutputIterator target)
+    {
+    if(count > m_size) throw std::logic_error{"Tried to pop more elements than BoundedBuffer holds"};
+
+    auto const head = first_segment();
+    auto const headCount = std::min(count, size_type(head.size()));
+    target = move_run(head.begin(), head.begin() + headCount, target);
+    target = move_run(ptr(), ptr() + (count - headCount), target);
+
+    drop_front(count);
+    return target;
+    }
+
   auto swap(BoundedBuffer & other) noexcept
     {
-    std::swap(m_maximumSize, other.m_maximumSize);
-    std::swap(m_first, other.m_first);
-    std::swap(m_size, other.m_size);
-    std::swap(m_data, other.m_data);
+    do_swap(other, typename __allocator_traits::propagate_on_container_swap{});
     }
 
   decltype(auto) operator=(BoundedBuffer const & other)
     {
     if(this != &other)
       {
-      auto temporary = BoundedBuffer{other};
-      swap(temporary);
+      auto temporary = BoundedBuffer{other, __allocator_traits::propagate_on_container_copy_assignment::value ? other.m_allocator
+                                                                                                              : m_allocator};
+      do_swap(temporary, typename __allocator_traits::propagate_on_container_copy_assignment{});
       }
 
     return *this;
     }
 
-  decltype(auto) operator=(BoundedBuffer && other) noexcept(noexcept(swap(other)))
+  decltype(auto) operator=(BoundedBuffer && other) noexcept(__allocator_traits::propagate_on_container_move_assignment::value)
     {
-    swap(other);
+    if(this != &other)
+      {
+      move_assign(other, typename __allocator_traits::propagate_on_container_move_assignment{});
+      }
+
     return *this;
     }
 
@@ -271,33 +455,212 @@ struct BoundedBuffer
     return end();
     }
 
+  /**
+   * The elements as at most two contiguous ranges, first_segment() starts with the front element. The second
+   * segment is only non-empty when the elements wrap around the end of the storage.
+   */
+  auto first_segment() noexcept
+    {
+    return segment{ptr() + m_first, ptr() + m_first + first_length()};
+    }
+
+  auto second_segment() noexcept
+    {
+    return segment{ptr(), ptr() + m_size - first_length()};
+    }
+
+  auto first_segment() const noexcept
+    {
+    return const_segment{ptr() + m_first, ptr() + m_first + first_length()};
+    }
+
+  auto second_segment() const noexcept
+    {
+    return const_segment{ptr(), ptr() + m_size - first_length()};
+    }
+
+  /**
+   * The free slots behind the back element as at most two contiguous ranges of raw storage. Elements have to be
+   * constructed in them in order, starting with first_free_segment(), before commit_back() appends them.
+   */
+  auto first_free_segment() noexcept
+    {
+    auto const start = ptr() + to_buffer_index(m_size);
+    return segment{start, start + first_free_length()};
+    }
+
+  auto second_free_segment() noexcept
+    {
+    return segment{ptr(), ptr() + (m_maximumSize - m_size - first_free_length())};
+    }
+
+  auto commit_back(size_type const count)
+    {
+    if(count > m_maximumSize - m_size) throw std::logic_error{"Tried to commit more than the free slots of BoundedBuffer"};
+    m_size += count;
+    }
+
   private:
+    template<typename Propagate>
+    auto do_swap(BoundedBuffer & other, Propagate const propagate) noexcept
+      {
+      std::swap(m_maximumSize, other.m_maximumSize);
+      swap_allocators(other, propagate);
+      std::swap(m_first, other.m_first);
+      std::swap(m_size, other.m_size);
+      std::swap(m_data, other.m_data);
+      }
+
+    auto move_assign(BoundedBuffer & other, std::true_type) noexcept
+      {
+      do_swap(other, std::true_type{});
+      }
+
+    auto move_assign(BoundedBuffer & other, std::false_type)
+      {
+      if(m_allocator == other.m_allocator)
+        {
+        do_swap(other, std::false_type{});
+        return;
+        }
+
+      auto temporary = BoundedBuffer{std::move(other), m_allocator};
+      do_swap(temporary, std::false_type{});
+      }
+
     auto do_pop() noexcept
       {
-      ptr()[m_first].~value_type();
+      __allocator_traits::destroy(m_allocator, ptr() + m_first);
 
-      m_first = (m_first + 1) % m_maximumSize;
+      m_first = to_buffer_index(1);
       --m_size;
       }
 
-    auto do_push(value_type const & elem) noexcept(noexcept(new (m_data) value_type{elem}))
+    auto drop_front(size_type const count) noexcept
       {
-      new (ptr() + push_index()) value_type{elem};
+      auto const head = first_segment();
+      auto const headCount = std::min(count, size_type(head.size()));
+      destroy_run(head.begin(), head.begin() + headCount);
+      destroy_run(ptr(), ptr() + (count - headCount));
+
+      m_first = to_buffer_index(count);
+      m_size -= count;
       }
 
-    auto back_index() const noexcept
+    /*
+     * memcpy is only allowed for trivially copyable elements, and only pays off when the source is contiguous,
+     * which before C++20 can only be known for pointers.
+     */
+    template<typename IteratorType>
+    using __bitwise = std::integral_constant<bool, std::is_trivially_copyable<value_type>::value &&
+                                                   std::is_convertible<IteratorType, const_pointer>::value>;
+
+    /*
+     * Construction and destruction go through the allocator, so they may only be short-cut if it does nothing
+     * beyond placement new and the destructor.
+     */
+    using __plain = buffer_detail::plain_construction<__allocator>;
+
+    template<typename InputIterator>
+    auto construct_run(InputIterator first, InputIterator const last, pointer const target)
       {
-      return to_buffer_index(m_size - 1);
+      return construct_run(first, last, target, std::integral_constant<bool, __bitwise<InputIterator>::value && __plain::value>{});
+      }
+
+    /*
+     * Like std::uninitialized_copy, the elements built so far are destroyed again if one of them throws.
+     */
+    template<typename InputIterator>
+    auto construct_run(InputIterator first, InputIterator const last, pointer const target, std::false_type)
+      {
+      auto current = target;
+
+      try
+        {
+        for(; first != last; ++first, ++current)
+          {
+          __allocator_traits::construct(m_allocator, current, *first);
+          }
+        }
+      catch(...)
+        {
+        destroy_run(target, current);
+        throw;
+        }
+
+      return current;
+      }
+
+    static auto construct_run(const_pointer const first, const_pointer const last, pointer const target, std::true_type) noexcept
+      {
+      return copy_bits(first, last, target);
+      }
+
+    template<typename OutputIterator>
+    static auto move_run(pointer const first, pointer const last, OutputIterator target)
+      {
+      return move_run(first, last, target, __bitwise<OutputIterator>{});
+      }
+
+    template<typename OutputIterator>
+    static auto move_run(pointer const first, pointer const last, OutputIterator target, std::false_type)
+      {
+      return std::move(first, last, target);
+      }
+
+    static auto move_run(pointer const first, pointer const last, pointer const target, std::true_type) noexcept
+      {
+      return copy_bits(first, last, target);
       }
 
-    auto push_index() noexcept
+    static auto copy_bits(const_pointer const first, const_pointer const last, pointer const target) noexcept
       {
-      return to_buffer_index(m_size++);
+      if(first != last)
+        {
+        std::memcpy(target, first, size_type(last - first) * sizeof(value_type));
+        }
+
+      return target + (last - first);
+      }
+
+    auto destroy_run(pointer first, pointer const last) noexcept
+      {
+      destroy_run(first, last, std::integral_constant<bool, std::is_trivially_destructible<value_type>::value && __plain::value>{});
+      }
+
+    auto destroy_run(pointer first, pointer const last, std::false_type) noexcept
+      {
+      for(; first != last; ++first)
+        {
+        __allocator_traits::destroy(m_allocator, first);
+        }
+      }
+
+    static auto destroy_run(pointer, pointer, std::true_type) noexcept
+      {
+
+      }
+
+    auto first_length() const noexcept
+      {
+      return std::min(m_size, m_maximumSize - m_first);
+      }
+
+    auto first_free_length() const noexcept
+      {
+      auto const end = m_first + m_size;
+      return end < m_maximumSize ? m_maximumSize - end : m_maximumSize - m_size;
+      }
+
+    auto back_index() const noexcept
+      {
+      return to_buffer_index(m_size - 1);
       }
 
     auto to_buffer_index(size_type const index) const noexcept
       {
-      return (m_first + index) % m_maximumSize;
+      auto const position = m_first + index;
+      return position < m_maximumSize ? position : position - m_maximumSize;
       }
 
     auto throw_if_empty() const
@@ -310,14 +673,25 @@ struct BoundedBuffer
       if(full()) throw std::logic_error{"BoundedBuffer is full"};
       }
 
+    auto swap_allocators(BoundedBuffer & other, std::true_type) noexcept
+      {
+      using std::swap;
+      swap(m_allocator, other.m_allocator);
+      }
+
+    auto swap_allocators(BoundedBuffer &, std::false_type) noexcept
+      {
+
+      }
+
     auto ptr() noexcept
       {
-      return reinterpret_cast<pointer>(m_data);
+      return m_data;
       }
 
     auto ptr() const noexcept
       {
-      return reinterpret_cast<const_pointer>(m_data);
+      return const_pointer{m_data};
       }
 
     decltype(auto) get(size_type const idx) noexcept
@@ -330,29 +704,30 @@ struct BoundedBuffer
       return ptr()[idx];
       }
 
-    auto copy(BoundedBuffer const & other) noexcept(noexcept(do_push(std::declval<value_type &>())))
+    /*
+     * The copy starts at the beginning of the storage, so trivially copyable elements take one memcpy per segment
+     * of other.
+     */
+    auto copy(BoundedBuffer const & other)
       {
-      for(auto const & element : other)
-        {
-        do_push(element);
-        }
+      auto const head = other.first_segment();
+      auto const tail = other.second_segment();
+
+      push_back_range(head.begin(), head.end());
+      push_back_range(tail.begin(), tail.end());
       }
 
-    auto clear() noexcept(noexcept(do_pop()))
+    auto clear() noexcept
       {
-      for(size_type idx = 0; idx < m_size; ++idx)
-        {
-        do_pop();
-        }
-
-      m_size = 0;
+      drop_front(m_size);
       m_first = 0;
       }
 
     size_type m_maximumSize{};
     size_type m_first{};
     size_type m_size{};
-    char * m_data{};
+    __allocator m_allocator;
+    pointer m_data{};
   };
 
 #endif
@@ -0,0 +1,134 @@
+#ifndef __FMO__BOUNDED_BUFFER_ALGORITHM
+#define __FMO__BOUNDED_BUFFER_ALGORITHM
+
+#include "BoundedBuffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <utility>
+
+/**
+ * Algorithms over all elements of a BoundedBuffer that split the traversal at the wrap point. Each of the at most
+ * two segments is handed to the std algorithm as a pointer range, so the library can use memmove and the compiler
+ * can vectorize, which buffer_iterator prevents.
+ */
+namespace segmented
+  {
+  namespace __detail
+    {
+    /*
+     * Compares the elements [from, to) of the buffer with the contiguous range starting at other.
+     */
+    template<typename BufferType, typename PointerType>
+    auto equal_elements(BufferType const & buffer, std::size_t const from, std::size_t const to, PointerType other)
+      {
+      auto const head = buffer.first_segment();
+      auto const tail = buffer.second_segment();
+      auto const headFrom = std::min(from, head.size());
+      auto const headTo = std::min(to, head.size());
+      auto const tailFrom = std::max(from, head.size()) - head.size();
+      auto const tailTo = std::max(to, head.size()) - head.size();
+
+      return std::equal(head.begin() + headFrom, head.begin() + headTo, other) &&
+             std::equal(tail.begin() + tailFrom, tail.begin() + tailTo, other + (headTo - headFrom));
+      }
+    }
+
+  template<typename BufferType, typename OutputIterator>
+  auto copy(BufferType const & buffer, OutputIterator target)
+    {
+    auto const head = buffer.first_segment();
+    auto const tail = buffer.second_segment();
+
+    return std::copy(tail.begin(), tail.end(), std::copy(head.begin(), head.end(), target));
+    }
+
+  template<typename BufferType, typename ValueType>
+  auto fill(BufferType & buffer, ValueType const & value)
+    {
+    auto const head = buffer.first_segment();
+    auto const tail = buffer.second_segment();
+
+    std::fill(head.begin(), head.end(), value);
+    std::fill(tail.begin(), tail.end(), value);
+    }
+
+  /**
+   * Returns the buffer iterator to the first element equal to value, or end().
+   */
+  template<typename BufferType, typename ValueType>
+  auto find(BufferType & buffer, ValueType const & value)
+    {
+    auto const head = buffer.first_segment();
+    auto const inHead = std::find(head.begin(), head.end(), value);
+
+    if(inHead != head.end())
+      {
+      return buffer.begin() + (inHead - head.begin());
+      }
+
+    auto const tail = buffer.second_segment();
+    return buffer.begin() + (head.size() + (std::find(tail.begin(), tail.end(), value) - tail.begin()));
+    }
+
+  template<typename BufferType, typename ResultType>
+  auto accumulate(BufferType const & buffer, ResultType initial)
+    {
+    auto const head = buffer.first_segment();
+    auto const tail = buffer.second_segment();
+
+    return std::accumulate(tail.begin(), tail.end(), std::accumulate(head.begin(), head.end(), std::move(initial)));
+    }
+
+  template<typename BufferType, typename ResultType, typename BinaryOperation>
+  auto accumulate(BufferType const & buffer, ResultType initial, BinaryOperation operation)
+    {
+    auto const head = buffer.first_segment();
+    auto const tail = buffer.second_segment();
+
+    auto headResult = std::accumulate(head.begin(), head.end(), std::move(initial), operation);
+    return std::accumulate(tail.begin(), tail.end(), std::move(headResult), operation);
+    }
+
+  template<typename BufferType, typename OutputIterator, typename UnaryOperation>
+  auto transform(BufferType const & buffer, OutputIterator target, UnaryOperation operation)
+    {
+    auto const head = buffer.first_segment();
+    auto const tail = buffer.second_segment();
+
+    return std::transform(tail.begin(), tail.end(), std::transform(head.begin(), head.end(), target, operation),
+                          operation);
+    }
+
+  /**
+   * Compares the elements with the range starting at other, which has to hold at least size() elements.
+   */
+  template<typename BufferType, typename InputIterator>
+  auto equal(BufferType const & buffer, InputIterator other)
+    {
+    auto const head = buffer.first_segment();
+    auto const tail = buffer.second_segment();
+    auto const rest = std::mismatch(head.begin(), head.end(), other);
+
+    return rest.first == head.end() && std::equal(tail.begin(), tail.end(), rest.second);
+    }
+
+  /**
+   * Compares two buffers element by element, regardless of where either of them wraps.
+   */
+  template<typename ValueType, typename AllocatorType, typename IteratorPolicy,
+           typename OtherAllocatorType, typename OtherIteratorPolicy>
+  auto equal(BoundedBuffer<ValueType, AllocatorType, IteratorPolicy> const & buffer,
+             BoundedBuffer<ValueType, OtherAllocatorType, OtherIteratorPolicy> const & other)
+    {
+    auto const head = other.first_segment();
+
+    return buffer.size() == other.size() &&
+           __detail::equal_elements(buffer, 0, head.size(), head.begin()) &&
+           __detail::equal_elements(buffer, head.size(), buffer.size(), other.second_segment().begin());
+    }
+  }
+
+#endif
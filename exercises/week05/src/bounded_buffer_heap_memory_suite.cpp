@@ -190,6 +190,49 @@ void test_copy_only_initialized_elements_in_copy_assignment(){
 }
 
 
+struct LifetimeCounter {
+  LifetimeCounter() {
+    constructions++;
+  }
+  LifetimeCounter(LifetimeCounter const &) {
+    constructions++;
+    copies++;
+  }
+  ~LifetimeCounter() {
+    destructions++;
+  }
+
+  static unsigned constructions;
+  static unsigned copies;
+  static unsigned destructions;
+  static void resetLifetimeCounters() {
+    constructions = 0;
+    copies = 0;
+    destructions = 0;
+  }
+};
+
+unsigned LifetimeCounter::constructions {0};
+unsigned LifetimeCounter::copies {0};
+unsigned LifetimeCounter::destructions {0};
+
+void test_copy_and_destruction_balance_element_lifetimes(){
+  LifetimeCounter::resetLifetimeCounters();
+  {
+    BoundedBuffer<LifetimeCounter> buffer{5};
+    5_times([&](){
+      buffer.push(LifetimeCounter{});
+      });
+    2_times([&](){
+      buffer.pop();
+      });
+    BoundedBuffer<LifetimeCounter> copy{buffer};
+    ASSERT_EQUAL(8, LifetimeCounter::copies);
+  }
+  ASSERT_EQUAL(LifetimeCounter::constructions, LifetimeCounter::destructions);
+}
+
+
 cute::suite make_suite_bounded_buffer_heap_memory_suite() {
   cute::suite s;
   s.push_back(CUTE(test_allocation_of_default_bounded_buffer));
@@ -200,6 +243,7 @@ cute::suite make_suite_bounded_buffer_heap_memory_suite() {
   s.push_back(CUTE(test_move_self_assignment_no_addtional_allocation));
   s.push_back(CUTE(test_copy_only_initialized_elements_in_copy_construction));
   s.push_back(CUTE(test_copy_only_initialized_elements_in_copy_assignment));
+  s.push_back(CUTE(test_copy_and_destruction_balance_element_lifetimes));
   s.push_back(CUTE(test_move_constructor_does_not_allocate_a_new_buffer));
   s.push_back(CUTE(test_copy_assignment_one_additional_allocation));
   s.push_back(CUTE(test_move_assignment_no_additional_allocation));
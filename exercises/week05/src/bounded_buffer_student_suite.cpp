@@ -1,12 +1,484 @@
 #include "BoundedBuffer.h"
+#include "BoundedBufferAlgorithm.h"
 #include "bounded_buffer_student_suite.h"
 #include <cute/cute.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+struct AllocationLog {
+	std::size_t allocations { };
+	std::size_t deallocations { };
+	std::size_t elements { };
+	std::size_t constructions { };
+	std::size_t destructions { };
+};
+
+template<typename T>
+struct LoggingAllocator {
+	using value_type = T;
+
+	explicit LoggingAllocator(AllocationLog & log) : log { &log } {
+	}
+
+	template<typename U>
+	LoggingAllocator(LoggingAllocator<U> const & other) : log { other.log } {
+	}
+
+	T * allocate(std::size_t n) {
+		log->allocations++;
+		log->elements += n;
+		return std::allocator<T> { }.allocate(n);
+	}
+
+	void deallocate(T * p, std::size_t n) {
+		log->deallocations++;
+		std::allocator<T> { }.deallocate(p, n);
+	}
+
+	template<typename U, typename... Args>
+	void construct(U * p, Args &&... args) {
+		log->constructions++;
+		::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+	}
+
+	template<typename U>
+	void destroy(U * p) {
+		log->destructions++;
+		p->~U();
+	}
+
+	AllocationLog * log;
+};
+
+template<typename T, typename U>
+bool operator==(LoggingAllocator<T> const & lhs, LoggingAllocator<U> const & rhs) {
+	return lhs.log == rhs.log;
+}
+
+template<typename T, typename U>
+bool operator!=(LoggingAllocator<T> const & lhs, LoggingAllocator<U> const & rhs) {
+	return !(lhs == rhs);
+}
+
+using LoggingBuffer = BoundedBuffer<int, LoggingAllocator<int>>;
+
+void test_buffer_allocates_storage_from_allocator() {
+	AllocationLog log { };
+	{
+		LoggingBuffer buffer { 5, LoggingAllocator<int> { log } };
+		buffer.push(1);
+		ASSERT_EQUAL(1, log.allocations);
+		ASSERT_EQUAL(5, log.elements);
+		ASSERT(buffer.get_allocator() == LoggingAllocator<int> { log });
+	}
+	ASSERT_EQUAL(1, log.deallocations);
+}
+
+void test_buffer_copy_uses_same_allocator() {
+	AllocationLog log { };
+	{
+		LoggingBuffer buffer { 3, LoggingAllocator<int> { log } };
+		buffer.push(1);
+		buffer.push(2);
+		LoggingBuffer copy { buffer };
+		ASSERT_EQUAL(2, log.allocations);
+		ASSERT_EQUAL(2, copy.back());
+	}
+	ASSERT_EQUAL(2, log.deallocations);
+}
+
+void test_moved_buffer_keeps_its_storage() {
+	AllocationLog log { };
+	{
+		LoggingBuffer buffer { 3, LoggingAllocator<int> { log } };
+		buffer.push(1);
+		LoggingBuffer moved { std::move(buffer) };
+		ASSERT_EQUAL(1, log.allocations);
+		ASSERT_EQUAL(1, moved.front());
+	}
+	ASSERT_EQUAL(1, log.deallocations);
+}
+
+void test_buffer_builds_elements_through_allocator() {
+	AllocationLog log { };
+	{
+		LoggingBuffer buffer { 4, LoggingAllocator<int> { log } };
+		buffer.push(1);
+		std::vector<int> const elements { 2, 3 };
+		buffer.push_back_range(elements.data(), elements.data() + elements.size());
+		ASSERT_EQUAL(3, log.constructions);
+		buffer.pop_front_n(2);
+		ASSERT_EQUAL(2, log.destructions);
+	}
+	ASSERT_EQUAL(3, log.destructions);
+}
+
+void test_move_assignment_moves_elements_into_own_storage() {
+	AllocationLog ours { }, theirs { };
+	{
+		LoggingBuffer buffer { 2, LoggingAllocator<int> { ours } };
+		LoggingBuffer other { 4, LoggingAllocator<int> { theirs } };
+		other.push(1);
+		other.push(2);
+		buffer = std::move(other);
+		ASSERT(buffer.get_allocator() == LoggingAllocator<int> { ours });
+		ASSERT_EQUAL(2, ours.allocations);
+		ASSERT_EQUAL(2, ours.constructions);
+		ASSERT_EQUAL(2, buffer.back());
+	}
+	ASSERT_EQUAL(ours.allocations, ours.deallocations);
+	ASSERT_EQUAL(theirs.allocations, theirs.deallocations);
+	ASSERT_EQUAL(ours.constructions, ours.destructions);
+}
+
+template<typename T>
+struct CopyPropagatingAllocator : LoggingAllocator<T> {
+	using propagate_on_container_copy_assignment = std::true_type;
+
+	explicit CopyPropagatingAllocator(AllocationLog & log) : LoggingAllocator<T> { log } {
+	}
+
+	template<typename U>
+	CopyPropagatingAllocator(CopyPropagatingAllocator<U> const & other) : LoggingAllocator<T> { other } {
+	}
+};
+
+void test_copy_assignment_propagates_allocator_on_request() {
+	AllocationLog ours { }, theirs { };
+	{
+		BoundedBuffer<int, CopyPropagatingAllocator<int>> buffer { 2, CopyPropagatingAllocator<int> { ours } };
+		BoundedBuffer<int, CopyPropagatingAllocator<int>> other { 4, CopyPropagatingAllocator<int> { theirs } };
+		other.push(3);
+		buffer = other;
+		ASSERT(buffer.get_allocator() == CopyPropagatingAllocator<int> { theirs });
+		ASSERT_EQUAL(3, buffer.front());
+	}
+	ASSERT_EQUAL(ours.allocations, ours.deallocations);
+	ASSERT_EQUAL(theirs.allocations, theirs.deallocations);
+}
+
+struct alignas(alignof(std::max_align_t)) Wide {
+	int value;
+};
+
+void test_buffer_storage_is_aligned_for_element_type() {
+	BoundedBuffer<Wide> buffer { 3 };
+	buffer.push(Wide { 1 });
+	buffer.push(Wide { 2 });
+	ASSERT_EQUAL(0, reinterpret_cast<std::uintptr_t>(&buffer.front()) % alignof(Wide));
+	ASSERT_EQUAL(0, reinterpret_cast<std::uintptr_t>(&buffer.back()) % alignof(Wide));
+}
+
+using UncheckedBuffer = BoundedBuffer<int, std::allocator<int>, buffer_iterator_policy::unchecked>;
+
+void test_unchecked_iterator_traverses_wrapped_buffer() {
+	UncheckedBuffer buffer { 4 };
+	for (int element { }; element < 6; ++element) {
+		if (buffer.full()) {
+			buffer.pop();
+		}
+		buffer.push(element);
+	}
+	std::vector<int> elements { };
+	for (auto const element : buffer) {
+		elements.push_back(element);
+	}
+	ASSERT_EQUAL((std::vector<int> { 2, 3, 4, 5 }), elements);
+	ASSERT_EQUAL(4, buffer.end() - buffer.begin());
+	ASSERT_EQUAL(5, *(buffer.cbegin() + 3));
+}
+
+void test_unchecked_iterator_operations_do_not_throw() {
+	UncheckedBuffer buffer { 4 };
+	auto iterator = buffer.begin();
+	ASSERT(noexcept(*iterator));
+	ASSERT(noexcept(++iterator));
+	ASSERT(noexcept(iterator += 2));
+	ASSERT(noexcept(iterator - buffer.begin()));
+	ASSERT(!noexcept(*BoundedBuffer<int> { 4 }.begin()));
+}
+
+using DebugCheckedBuffer = BoundedBuffer<int, std::allocator<int>, buffer_iterator_policy::debug_checked>;
+
+void test_debug_checked_iterator_checks_unless_ndebug() {
+	DebugCheckedBuffer buffer { 4 };
+	buffer.push(1);
+	ASSERT_EQUAL(1, *buffer.begin());
+#ifdef NDEBUG
+	ASSERT(noexcept(*buffer.begin()));
+#else
+	ASSERT(!noexcept(*buffer.begin()));
+	ASSERT_THROWS(*buffer.end(), std::out_of_range);
+#endif
+}
+
+BoundedBuffer<int> wrapped_buffer() {
+	BoundedBuffer<int> buffer { 5 };
+	for (int element { }; element < 7; ++element) {
+		if (buffer.full()) {
+			buffer.pop();
+		}
+		buffer.push(element);
+	}
+	buffer.pop();
+	return buffer;
+}
+
+void test_segments_split_elements_at_wrap_point() {
+	auto const buffer = wrapped_buffer();
+	auto const first = buffer.first_segment();
+	auto const second = buffer.second_segment();
+	ASSERT_EQUAL((std::vector<int> { 3, 4 }), std::vector<int>(first.begin(), first.end()));
+	ASSERT_EQUAL((std::vector<int> { 5, 6 }), std::vector<int>(second.begin(), second.end()));
+	ASSERT_EQUAL(&buffer.front(), first.begin());
+}
+
+void test_second_segment_is_empty_without_wrap() {
+	BoundedBuffer<int> buffer { 5 };
+	buffer.push(1);
+	buffer.push(2);
+	ASSERT_EQUAL(2, buffer.first_segment().size());
+	ASSERT(buffer.second_segment().empty());
+}
+
+void test_free_segments_cover_free_slots() {
+	auto buffer = wrapped_buffer();
+	ASSERT_EQUAL(1, buffer.first_free_segment().size());
+	ASSERT(buffer.second_free_segment().empty());
+	ASSERT_EQUAL(&buffer.back() + 1, buffer.first_free_segment().begin());
+	buffer.pop();
+	ASSERT_EQUAL(2, buffer.first_free_segment().size());
+	ASSERT(buffer.second_free_segment().empty());
+	ASSERT_EQUAL(buffer.second_segment().end(), buffer.first_free_segment().begin());
+}
+
+void test_commit_back_appends_elements_written_to_free_segments() {
+	BoundedBuffer<int> buffer { 4 };
+	buffer.push(0);
+	buffer.push(0);
+	buffer.pop();
+	buffer.pop();
+	int const elements[] { 1, 2, 3 };
+	auto const free = buffer.first_free_segment();
+	ASSERT_EQUAL(2, free.size());
+	std::memcpy(free.begin(), elements, 2 * sizeof(int));
+	std::memcpy(buffer.second_free_segment().begin(), elements + 2, sizeof(int));
+	buffer.commit_back(3);
+	ASSERT_EQUAL((std::vector<int> { 1, 2, 3 }), std::vector<int>(buffer.begin(), buffer.end()));
+	ASSERT_THROWS(buffer.commit_back(2), std::logic_error);
+}
+
+void test_segmented_copy_keeps_element_order() {
+	auto const buffer = wrapped_buffer();
+	std::vector<int> elements { };
+	segmented::copy(buffer, std::back_inserter(elements));
+	ASSERT_EQUAL((std::vector<int> { 3, 4, 5, 6 }), elements);
+}
+
+void test_segmented_fill_overwrites_all_elements() {
+	auto buffer = wrapped_buffer();
+	segmented::fill(buffer, 7);
+	ASSERT_EQUAL((std::vector<int> { 7, 7, 7, 7 }), std::vector<int>(buffer.begin(), buffer.end()));
+}
+
+void test_segmented_find_returns_buffer_iterator() {
+	auto buffer = wrapped_buffer();
+	ASSERT_EQUAL(1, segmented::find(buffer, 4) - buffer.begin());
+	ASSERT_EQUAL(3, segmented::find(buffer, 6) - buffer.begin());
+	ASSERT(segmented::find(buffer, 2) == buffer.end());
+}
+
+void test_segmented_accumulate_sums_both_segments() {
+	auto const buffer = wrapped_buffer();
+	ASSERT_EQUAL(18, segmented::accumulate(buffer, 0));
+	ASSERT_EQUAL(360, segmented::accumulate(buffer, 1, std::multiplies<int> { }));
+}
+
+void test_segmented_transform_applies_operation_in_order() {
+	auto const buffer = wrapped_buffer();
+	std::vector<int> doubled(4);
+	auto const end = segmented::transform(buffer, doubled.begin(), [](int element) { return 2 * element; });
+	ASSERT(end == doubled.end());
+	ASSERT_EQUAL((std::vector<int> { 6, 8, 10, 12 }), doubled);
+}
+
+void test_segmented_equal_compares_buffers_with_different_wrap_points() {
+	auto const buffer = wrapped_buffer();
+	BoundedBuffer<int, std::allocator<int>, buffer_iterator_policy::unchecked> other { 6 };
+	for (int element { 3 }; element < 7; ++element) {
+		other.push(element);
+	}
+	ASSERT(segmented::equal(buffer, other));
+	ASSERT(segmented::equal(other, buffer));
+	ASSERT(segmented::equal(buffer, std::vector<int> { 3, 4, 5, 6 }.begin()));
+	other.pop();
+	other.push(7);
+	ASSERT(!segmented::equal(buffer, other));
+	other.pop();
+	ASSERT(!segmented::equal(buffer, other));
+}
+
+void test_push_back_range_appends_in_two_runs() {
+	BoundedBuffer<int> buffer { 5 };
+	buffer.push(1);
+	buffer.push(2);
+	buffer.push(3);
+	buffer.pop_front_n(2);
+	int const elements[] { 4, 5, 6, 7 };
+	buffer.push_back_range(std::begin(elements), std::end(elements));
+	ASSERT_EQUAL((std::vector<int> { 3, 4, 5, 6, 7 }), std::vector<int>(buffer.begin(), buffer.end()));
+	ASSERT_EQUAL(2, buffer.second_segment().size());
+}
+
+void test_push_back_range_accepts_forward_iterators() {
+	BoundedBuffer<std::string> buffer { 3 };
+	std::vector<std::string> const elements { "one", "two" };
+	buffer.push_back_range(elements.begin(), elements.end());
+	ASSERT_EQUAL(2, buffer.size());
+	ASSERT_EQUAL("two", buffer.back());
+}
+
+void test_push_back_range_pushes_nothing_if_elements_do_not_fit() {
+	auto buffer = wrapped_buffer();
+	std::vector<int> const elements { 7, 8 };
+	ASSERT_THROWS(buffer.push_back_range(elements.begin(), elements.end()), std::logic_error);
+	ASSERT_EQUAL(4, buffer.size());
+}
+
+struct FragileCopy {
+	explicit FragileCopy(int value) : value { value } {
+		++alive;
+	}
+
+	FragileCopy(FragileCopy const & other) : value { other.value } {
+		if (value < 0) {
+			throw std::runtime_error { "fragile" };
+		}
+		++alive;
+	}
+
+	~FragileCopy() {
+		--alive;
+	}
+
+	int value;
+
+	static int alive;
+};
+
+int FragileCopy::alive { 0 };
+
+void test_push_back_range_leaves_buffer_unchanged_if_copy_throws() {
+	{
+		BoundedBuffer<FragileCopy> buffer { 4 };
+		buffer.push(FragileCopy { 1 });
+		buffer.push(FragileCopy { 1 });
+		buffer.pop();
+		buffer.pop();
+		buffer.push(FragileCopy { 1 });
+		std::vector<FragileCopy> elements { };
+		elements.reserve(3);
+		elements.emplace_back(2);
+		elements.emplace_back(3);
+		elements.emplace_back(-1);
+		ASSERT_THROWS(buffer.push_back_range(elements.begin(), elements.end()), std::runtime_error);
+		ASSERT_EQUAL(1, buffer.size());
+		ASSERT_EQUAL(4, FragileCopy::alive);
+	}
+	ASSERT_EQUAL(0, FragileCopy::alive);
+}
+
+void test_pop_front_n_removes_elements_across_wrap_point() {
+	auto buffer = wrapped_buffer();
+	buffer.pop_front_n(3);
+	ASSERT_EQUAL(1, buffer.size());
+	ASSERT_EQUAL(6, buffer.front());
+	ASSERT_THROWS(buffer.pop_front_n(2), std::logic_error);
+}
+
+void test_pop_front_n_moves_elements_to_target() {
+	auto buffer = wrapped_buffer();
+	int elements[3] { };
+	ASSERT_EQUAL(std::end(elements), buffer.pop_front_n(3, elements));
+	ASSERT_EQUAL((std::vector<int> { 3, 4, 5 }), std::vector<int>(std::begin(elements), std::end(elements)));
+	std::vector<int> rest { };
+	buffer.pop_front_n(1, std::back_inserter(rest));
+	ASSERT_EQUAL(std::vector<int> { 6 }, rest);
+	ASSERT(buffer.empty());
+}
+
+void test_pop_front_n_destroys_elements() {
+	{
+		BoundedBuffer<FragileCopy> buffer { 3 };
+		buffer.push(FragileCopy { 1 });
+		buffer.push(FragileCopy { 2 });
+		buffer.pop_front_n(2);
+		ASSERT_EQUAL(0, FragileCopy::alive);
+	}
+	ASSERT_EQUAL(0, FragileCopy::alive);
+}
+
+void test_copy_starts_at_beginning_of_storage() {
+	auto const buffer = wrapped_buffer();
+	auto const copy = buffer;
+	ASSERT(copy.second_segment().empty());
+	ASSERT_EQUAL(&copy.front(), copy.first_segment().begin());
+	ASSERT(segmented::equal(buffer, copy));
+}
+
+void test_destructor_destroys_all_elements() {
+	{
+		BoundedBuffer<FragileCopy> buffer { 3 };
+		buffer.push(FragileCopy { 1 });
+		buffer.push(FragileCopy { 2 });
+		buffer.push(FragileCopy { 3 });
+		auto const copy = buffer;
+		ASSERT_EQUAL(6, FragileCopy::alive);
+	}
+	ASSERT_EQUAL(0, FragileCopy::alive);
+}
+
 
 cute::suite make_suite_bounded_buffer_student_suite(){
 	cute::suite s;
-
+	s.push_back(CUTE(test_buffer_allocates_storage_from_allocator));
+	s.push_back(CUTE(test_buffer_copy_uses_same_allocator));
+	s.push_back(CUTE(test_moved_buffer_keeps_its_storage));
+	s.push_back(CUTE(test_buffer_builds_elements_through_allocator));
+	s.push_back(CUTE(test_move_assignment_moves_elements_into_own_storage));
+	s.push_back(CUTE(test_copy_assignment_propagates_allocator_on_request));
+	s.push_back(CUTE(test_buffer_storage_is_aligned_for_element_type));
+	s.push_back(CUTE(test_unchecked_iterator_traverses_wrapped_buffer));
+	s.push_back(CUTE(test_unchecked_iterator_operations_do_not_throw));
+	s.push_back(CUTE(test_debug_checked_iterator_checks_unless_ndebug));
+	s.push_back(CUTE(test_segments_split_elements_at_wrap_point));
+	s.push_back(CUTE(test_second_segment_is_empty_without_wrap));
+	s.push_back(CUTE(test_free_segments_cover_free_slots));
+	s.push_back(CUTE(test_commit_back_appends_elements_written_to_free_segments));
+	s.push_back(CUTE(test_segmented_copy_keeps_element_order));
+	s.push_back(CUTE(test_segmented_fill_overwrites_all_elements));
+	s.push_back(CUTE(test_segmented_find_returns_buffer_iterator));
+	s.push_back(CUTE(test_segmented_accumulate_sums_both_segments));
+	s.push_back(CUTE(test_segmented_transform_applies_operation_in_order));
+	s.push_back(CUTE(test_segmented_equal_compares_buffers_with_different_wrap_points));
+	s.push_back(CUTE(test_push_back_range_appends_in_two_runs));
+	s.push_back(CUTE(test_push_back_range_accepts_forward_iterators));
+	s.push_back(CUTE(test_push_back_range_pushes_nothing_if_elements_do_not_fit));
+	s.push_back(CUTE(test_push_back_range_leaves_buffer_unchanged_if_copy_throws));
+	s.push_back(CUTE(test_pop_front_n_removes_elements_across_wrap_point));
+	s.push_back(CUTE(test_pop_front_n_moves_elements_to_target));
+	s.push_back(CUTE(test_pop_front_n_destroys_elements));
+	s.push_back(CUTE(test_copy_starts_at_beginning_of_storage));
+	s.push_back(CUTE(test_destructor_destroys_all_elements));
 	return s;
 }
 
@@ -0,0 +1,200 @@
+#include "BoundedQueue.h"
+#include "SpinningCondition.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+  {
+  using clock = std::chrono::steady_clock;
+
+  /*
+   * The element type carries its own send time stamp, the payload only scales the element size.
+   */
+  template<std::size_t PayloadSize>
+  struct message
+    {
+    clock::time_point sent;
+    std::array<unsigned char, PayloadSize> payload;
+    };
+
+  /*
+   * A test-and-test-and-set lock as alternative MutexType. It is meant to be combined with one of the spinning
+   * wait strategies, since std::condition_variable only works with std::mutex.
+   */
+  struct spin_lock
+    {
+    void lock() noexcept
+      {
+      while(m_locked.exchange(true, std::memory_order_acquire))
+        {
+        while(m_locked.load(std::memory_order_relaxed))
+          {
+          wait_strategy::cpu_relax();
+          }
+        }
+      }
+
+    bool try_lock() noexcept
+      {
+      return !m_locked.load(std::memory_order_relaxed) && !m_locked.exchange(true, std::memory_order_acquire);
+      }
+
+    void unlock() noexcept
+      {
+      m_locked.store(false, std::memory_order_release);
+      }
+
+    private:
+      std::atomic<bool> m_locked{};
+    };
+
+  struct topology
+    {
+    std::size_t producers;
+    std::size_t consumers;
+    };
+
+  struct result
+    {
+    double operationsPerSecond;
+    clock::rep p50;
+    clock::rep p99;
+    clock::rep p999;
+    };
+
+  auto percentile(std::vector<clock::rep> & latencies, double const fraction)
+    {
+    auto const rank = latencies.begin() + static_cast<std::ptrdiff_t>(fraction * (latencies.size() - 1));
+    std::nth_element(latencies.begin(), rank, latencies.end());
+    return *rank;
+    }
+
+  /*
+   * Runs the producers and consumers of one topology against a single queue. Consumers drain until the last
+   * producer closes the queue and record the hand-off latency of every element they take.
+   */
+  template<typename QueueType>
+  auto measure(std::size_t const elements, std::size_t const capacity, topology const shape)
+    {
+    using element_type = typename QueueType::value_type;
+
+    QueueType queue{capacity};
+    auto const perProducer = elements / shape.producers;
+    std::atomic<std::size_t> activeProducers{shape.producers};
+    auto latencies = std::vector<std::vector<clock::rep>>(shape.consumers);
+
+    auto workers = std::vector<std::thread>{};
+    auto const start = clock::now();
+
+    for(std::size_t producer{}; producer < shape.producers; ++producer)
+      {
+      workers.emplace_back([&]{
+        for(std::size_t element{}; element < perProducer; ++element)
+          {
+          queue.push(element_type{clock::now(), {}});
+          }
+
+        if(activeProducers.fetch_sub(1) == 1)
+          {
+          queue.close();
+          }
+      });
+      }
+
+    for(auto & consumed : latencies)
+      {
+      consumed.reserve(perProducer * shape.producers);
+
+      workers.emplace_back([&]{
+        while(queue.consume([&](element_type const & element){ consumed.push_back((clock::now() - element.sent).count()); }))
+          {
+          }
+      });
+      }
+
+    for(auto & worker : workers)
+      {
+      worker.join();
+      }
+
+    auto const elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    auto merged = std::vector<clock::rep>{};
+
+    for(auto const & consumed : latencies)
+      {
+      merged.insert(merged.end(), consumed.begin(), consumed.end());
+      }
+
+    if(merged.size() != perProducer * shape.producers)
+      {
+      std::cerr << "lost elements\n";
+      std::exit(EXIT_FAILURE);
+      }
+
+    return result{merged.size() / elapsed, percentile(merged, 0.5), percentile(merged, 0.99), percentile(merged, 0.999)};
+    }
+
+  template<typename QueueType>
+  auto report(std::string const & name, std::size_t const elements, std::size_t const capacity, topology const shape)
+    {
+    auto const measured = measure<QueueType>(elements, capacity, shape);
+
+    std::cout << name << ','
+              << shape.producers << ','
+              << shape.consumers << ','
+              << capacity << ','
+              << sizeof(typename QueueType::value_type) << ','
+              << static_cast<std::size_t>(measured.operationsPerSecond) << ','
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(clock::duration{measured.p50}).count() << ','
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(clock::duration{measured.p99}).count() << ','
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(clock::duration{measured.p999}).count() << '\n';
+    }
+
+  template<std::size_t PayloadSize>
+  auto compare(std::size_t const elements, std::size_t const capacity, topology const shape)
+    {
+    using element_type = message<PayloadSize>;
+
+    report<BoundedQueue<element_type>>("locked/std::mutex", elements, capacity, shape);
+    report<BoundedQueue<element_type, std::mutex, wait_strategy::spin_then_block>>("locked/spin_then_block", elements, capacity, shape);
+    report<BoundedQueue<element_type, spin_lock, wait_strategy::spin_then_yield>>("locked/spin_lock", elements, capacity, shape);
+    report<BoundedQueue<element_type, std::mutex, std::condition_variable, queue_policy::mpmc>>("mpmc", elements, capacity, shape);
+
+    if(shape.producers == 1 && shape.consumers == 1)
+      {
+      report<BoundedQueue<element_type, std::mutex, std::condition_variable, queue_policy::spsc>>("spsc", elements, capacity, shape);
+      }
+    }
+  }
+
+/*
+ * Prints one CSV line per queue, topology, capacity and element size. Latencies are hand-off times from the
+ * producer's push to the consumer's consume in nanoseconds.
+ */
+int main(int argc, char const * argv[])
+  {
+  auto const elements = argc > 1 ? std::stoul(argv[1]) : 200000ul;
+  auto const many = std::max<std::size_t>(2, std::thread::hardware_concurrency() / 2);
+  auto const topologies = {topology{1, 1}, topology{many, 1}, topology{1, many}, topology{many, many}};
+
+  std::cout << "queue,producers,consumers,capacity,element_size,ops_per_second,p50_ns,p99_ns,p999_ns\n";
+
+  for(auto const shape : topologies)
+    {
+    for(auto const capacity : {16ul, 1024ul})
+      {
+      compare<8>(elements, capacity, shape);
+      compare<248>(elements, capacity, shape);
+      }
+    }
+  }
@@ -0,0 +1,103 @@
+#include "BoundedQueue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+  {
+  template<typename SynchronizationPolicy, typename LayoutPolicy>
+  using queue = BoundedQueue<std::size_t, std::mutex, std::condition_variable, SynchronizationPolicy, LayoutPolicy>;
+
+  /*
+   * Moves elements from producer threads to consumer threads through a single queue and reports the achieved
+   * hand-offs per second. Producers and consumers run on separate threads, so every hand-off crosses cores.
+   */
+  template<typename QueueType>
+  auto measure(std::size_t const elements, std::size_t const capacity, std::size_t const threads)
+    {
+    QueueType queue{capacity};
+    auto const perThread = elements / threads;
+    auto checksum = std::size_t{};
+    std::mutex checksumMutex{};
+
+    auto workers = std::vector<std::thread>{};
+    auto const start = std::chrono::steady_clock::now();
+
+    for(std::size_t thread{}; thread < threads; ++thread)
+      {
+      workers.emplace_back([&]{
+        for(std::size_t element{}; element < perThread; ++element)
+          {
+          queue.push(element);
+          }
+      });
+
+      workers.emplace_back([&]{
+        auto sum = std::size_t{};
+
+        for(std::size_t element{}; element < perThread; ++element)
+          {
+          sum += queue.pop();
+          }
+
+        std::lock_guard<std::mutex> guard{checksumMutex};
+        checksum += sum;
+      });
+      }
+
+    for(auto & worker : workers)
+      {
+      worker.join();
+      }
+
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if(checksum != threads * (perThread * (perThread - 1) / 2))
+      {
+      std::cerr << "checksum mismatch\n";
+      std::exit(EXIT_FAILURE);
+      }
+
+    return perThread * threads / elapsed;
+    }
+
+  template<typename SynchronizationPolicy>
+  auto compare(std::string const & name, std::size_t const elements, std::size_t const capacity, std::size_t const threads)
+    {
+    auto const compact = measure<queue<SynchronizationPolicy, queue_layout::compact>>(elements, capacity, threads);
+    auto const padded = measure<queue<SynchronizationPolicy, queue_layout::padded>>(elements, capacity, threads);
+
+    std::cout << std::left << std::setw(8) << name
+              << std::right << std::setw(10) << capacity
+              << std::setw(9) << threads
+              << std::setw(16) << std::fixed << std::setprecision(0) << compact
+              << std::setw(16) << padded
+              << std::setw(10) << std::setprecision(2) << padded / compact << '\n';
+    }
+  }
+
+int main(int argc, char const * argv[])
+  {
+  auto const elements = argc > 1 ? std::stoul(argv[1]) : 2000000ul;
+
+  std::cout << std::left << std::setw(8) << "policy"
+            << std::right << std::setw(10) << "capacity"
+            << std::setw(9) << "pairs"
+            << std::setw(16) << "compact ops/s"
+            << std::setw(16) << "padded ops/s"
+            << std::setw(10) << "speedup" << '\n';
+
+  for(auto const capacity : {64ul, 1024ul})
+    {
+    compare<queue_policy::spsc>("spsc", elements, capacity, 1);
+    compare<queue_policy::mpmc>("mpmc", elements, capacity, 2);
+    compare<queue_policy::locked>("locked", elements / 4, capacity, 2);
+    }
+  }
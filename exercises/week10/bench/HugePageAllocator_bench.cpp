@@ -0,0 +1,111 @@
+#include "BoundedQueue.h"
+#include "HugePageAllocator.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace
+  {
+  template<typename AllocatorType>
+  using queue = BoundedQueue<std::size_t, std::mutex, std::condition_variable, queue_policy::spsc, queue_layout::padded,
+                             queue_statistics::disabled, AllocatorType>;
+
+  using clock = std::chrono::steady_clock;
+
+  auto per_second(std::size_t const elements, clock::time_point const start)
+    {
+    return elements / std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+  /*
+   * Fills the whole ring and drains it again on a single thread, so every slot is touched in order. The first
+   * round faults the pages in and is not measured.
+   */
+  template<typename AllocatorType>
+  auto traversal(std::size_t const capacity, std::size_t const rounds)
+    {
+    queue<AllocatorType> ring{capacity};
+    auto element = std::size_t{};
+    auto start = clock::now();
+
+    for(std::size_t round{}; round <= rounds; ++round)
+      {
+      if(round == 1)
+        {
+        start = clock::now();
+        }
+
+      for(std::size_t pushed{}; pushed < capacity; ++pushed)
+        {
+        ring.try_push(pushed);
+        }
+
+      while(ring.try_pop(element))
+        {
+
+        }
+      }
+
+    return per_second(2 * capacity * rounds, start);
+    }
+
+  /*
+   * A producer and a consumer thread hand elements over through the ring. The consumer trails the producer, so
+   * both walk the whole ring and its pages.
+   */
+  template<typename AllocatorType>
+  auto hand_off(std::size_t const capacity, std::size_t const rounds)
+    {
+    queue<AllocatorType> ring{capacity};
+    auto const elements = capacity * rounds;
+    auto const start = clock::now();
+
+    std::thread producer{[&]{
+      for(std::size_t element{}; element < elements; ++element)
+        {
+        ring.push(element);
+        }
+    }};
+
+    for(std::size_t element{}; element < elements; ++element)
+      {
+      ring.pop();
+      }
+
+    producer.join();
+    return per_second(elements, start);
+    }
+  }
+
+int main(int argc, char const * argv[])
+  {
+  auto const rounds = argc > 1 ? std::stoul(argv[1]) : 4ul;
+
+  std::cout << std::right << std::setw(12) << "slots"
+            << std::setw(12) << "test"
+            << std::setw(18) << "default elem/s"
+            << std::setw(18) << "huge page elem/s"
+            << std::setw(10) << "speedup" << '\n';
+
+  for(auto const capacity : {std::size_t{1} << 16, std::size_t{1} << 20, std::size_t{1} << 23})
+    {
+    auto const report = [&](auto const & name, double const standard, double const huge){
+      std::cout << std::setw(12) << capacity
+                << std::setw(12) << name
+                << std::setw(18) << std::fixed << std::setprecision(0) << standard
+                << std::setw(18) << huge
+                << std::setw(10) << std::setprecision(2) << huge / standard << '\n';
+    };
+
+    report("traversal", traversal<std::allocator<std::size_t>>(capacity, rounds),
+                        traversal<HugePageAllocator<std::size_t>>(capacity, rounds));
+    report("hand-off", hand_off<std::allocator<std::size_t>>(capacity, rounds),
+                       hand_off<HugePageAllocator<std::size_t>>(capacity, rounds));
+    }
+  }
@@ -0,0 +1,81 @@
+#include "BoundedQueue.h"
+#include "ShardedBoundedQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+  {
+  using shared_queue = BoundedQueue<std::size_t, std::mutex, std::condition_variable, queue_policy::mpmc>;
+  using sharded_queue = ShardedBoundedQueue<std::size_t>;
+
+  constexpr std::size_t burst{64};
+
+  /*
+   * Every thread alternates between pushing a burst and popping the same number of elements, the N:M pattern of
+   * a pipeline stage that feeds itself. Both queues hold four bursts per thread. Reports the elements moved per
+   * second over all threads.
+   */
+  template<typename QueueType>
+  auto measure(QueueType & queue, std::size_t const elements, std::size_t const threads)
+    {
+    std::vector<std::thread> workers{};
+    auto const start = std::chrono::steady_clock::now();
+
+    for(std::size_t thread{}; thread < threads; ++thread)
+      {
+      workers.emplace_back([&]{
+        for(std::size_t done{}; done < elements; done += burst)
+          {
+          for(std::size_t element{}; element < burst; ++element)
+            {
+            queue.push(element);
+            }
+
+          for(std::size_t element{}; element < burst; ++element)
+            {
+            queue.pop();
+            }
+          }
+      });
+      }
+
+    for(auto & worker : workers)
+      {
+      worker.join();
+      }
+
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threads * elements / elapsed;
+    }
+  }
+
+int main(int argc, char const * argv[])
+  {
+  auto const elements = argc > 1 ? std::stoul(argv[1]) : 1000000ul;
+  auto const cores = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << std::right << std::setw(8) << "threads"
+            << std::setw(18) << "shared elem/s"
+            << std::setw(18) << "sharded elem/s"
+            << std::setw(10) << "speedup" << '\n';
+
+  for(auto threads = 1u; threads <= cores; threads = threads < cores && threads * 2 > cores ? cores : threads * 2)
+    {
+    shared_queue sharedQueue{4 * burst * threads};
+    sharded_queue shardedQueue{4 * burst, threads};
+
+    auto const shared = measure(sharedQueue, elements, threads);
+    auto const sharded = measure(shardedQueue, elements, threads);
+
+    std::cout << std::setw(8) << threads
+              << std::setw(18) << std::fixed << std::setprecision(0) << shared
+              << std::setw(18) << sharded
+              << std::setw(10) << std::setprecision(2) << sharded / shared << '\n';
+    }
+  }
@@ -0,0 +1,168 @@
+#include "BoundedQueue.h"
+#include "WorkStealingExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+  {
+  using task = std::function<void()>;
+
+  constexpr std::size_t fanout{16};
+
+  /*
+   * A few hundred nanoseconds of work that the compiler cannot drop.
+   */
+  auto work(std::size_t const iterations)
+    {
+    auto volatile sink = std::size_t{};
+
+    for(std::size_t iteration{}; iteration < iterations; ++iteration)
+      {
+      sink = sink + iteration;
+      }
+    }
+
+  auto wait_for(std::atomic<std::size_t> const & completed, std::size_t const expected)
+    {
+    while(completed.load() != expected)
+      {
+      std::this_thread::yield();
+      }
+    }
+
+  /*
+   * The thread pool as we used to write it: all workers pop from one shared BoundedQueue. Tasks spawned by a
+   * task are pushed back into the same queue, or run inline when it is full, since blocking would deadlock. The
+   * workers pop instead of consume, because a task must not run under the queue lock it pushes into.
+   */
+  struct shared_queue_pool
+    {
+    shared_queue_pool(std::size_t const threads, std::size_t const capacity)
+      : queue{capacity}
+      {
+      for(std::size_t thread{}; thread < threads; ++thread)
+        {
+        workers.emplace_back([this]{
+          for(task next{}; queue.pop_into(&next, 1); )
+            {
+            next();
+            }
+        });
+        }
+      }
+
+    ~shared_queue_pool()
+      {
+      queue.close();
+
+      for(auto & worker : workers)
+        {
+        worker.join();
+        }
+      }
+
+    auto submit(task next)
+      {
+      queue.push(std::move(next));
+      }
+
+    auto spawn(task next)
+      {
+      if(!queue.try_push(next))
+        {
+        next();
+        }
+      }
+
+    BoundedQueue<task> queue;
+    std::vector<std::thread> workers{};
+    };
+
+  struct stealing_pool
+    {
+    stealing_pool(std::size_t const threads, std::size_t const capacity)
+      : executor{threads, capacity}
+      {
+
+      }
+
+    auto submit(task next)
+      {
+      executor.submit(std::move(next));
+      }
+
+    auto spawn(task next)
+      {
+      executor.submit(std::move(next));
+      }
+
+    WorkStealingExecutor<> executor;
+    };
+
+  /*
+   * Submits root tasks from the outside, every root spawns fanout children from inside the pool. Reports the
+   * executed tasks per second.
+   */
+  template<typename PoolType>
+  auto measure(std::size_t const roots, std::size_t const threads, std::size_t const iterations)
+    {
+    PoolType pool{threads, 256};
+    std::atomic<std::size_t> completed{};
+    auto const start = std::chrono::steady_clock::now();
+
+    for(std::size_t root{}; root < roots; ++root)
+      {
+      pool.submit([&]{
+        for(std::size_t child{}; child < fanout; ++child)
+          {
+          pool.spawn([&]{
+            work(iterations);
+            ++completed;
+          });
+          }
+
+        ++completed;
+      });
+      }
+
+    wait_for(completed, roots * (fanout + 1));
+
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return completed.load() / elapsed;
+    }
+  }
+
+int main(int argc, char const * argv[])
+  {
+  auto const roots = argc > 1 ? std::stoul(argv[1]) : 20000ul;
+  auto const cores = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << std::right << std::setw(8) << "threads"
+            << std::setw(12) << "work"
+            << std::setw(18) << "shared tasks/s"
+            << std::setw(18) << "stealing tasks/s"
+            << std::setw(10) << "speedup" << '\n';
+
+  for(auto const iterations : {10ul, 1000ul})
+    {
+    for(auto threads = 1u; threads <= cores; threads = threads < cores && threads * 2 > cores ? cores : threads * 2)
+      {
+      auto const shared = measure<shared_queue_pool>(roots, threads, iterations);
+      auto const stealing = measure<stealing_pool>(roots, threads, iterations);
+
+      std::cout << std::setw(8) << threads
+                << std::setw(12) << iterations
+                << std::setw(18) << std::fixed << std::setprecision(0) << shared
+                << std::setw(18) << stealing
+                << std::setw(10) << std::setprecision(2) << stealing / shared << '\n';
+      }
+    }
+  }
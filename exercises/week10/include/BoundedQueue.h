@@ -1,37 +1,534 @@
 #ifndef __FMO__BOUNDED_QUEUE
 #define __FMO__BOUNDED_QUEUE
 
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
+#include <type_traits>
 #include <utility>
 
-template<typename ValueType, typename MutexType = std::mutex, typename ConditionType = std::condition_variable>
+/**
+ * Thrown when pushing to a closed BoundedQueue, and when a blocking pop finds a closed queue without elements.
+ */
+struct queue_closed : std::runtime_error
+  {
+  using std::runtime_error::runtime_error;
+  };
+
+namespace queue_layout
+  {
+  constexpr std::size_t cache_line_size{64};
+
+  /**
+   * All members are packed next to each other.
+   */
+  struct compact
+    {
+    static constexpr std::size_t alignment{1};
+    };
+
+  /**
+   * Configuration, producer owned state, consumer owned state and the blocking support each start on their own
+   * cache line, so producer and consumer threads do not invalidate each other's lines.
+   */
+  struct padded
+    {
+    static constexpr std::size_t alignment{cache_line_size};
+    };
+
+  template<typename LayoutPolicy, typename MemberType>
+  constexpr std::size_t alignment = std::max(LayoutPolicy::alignment, alignof(MemberType));
+  }
+
+namespace queue_policy
+  {
+  /**
+   * Every operation is serialized through a single mutex. Safe for any number of producers and consumers.
+   */
+  struct locked
+    {
+    using default_layout = queue_layout::compact;
+    };
+
+  /**
+   * Exactly one producer thread and one consumer thread. Elements are handed over through acquire/release
+   * indices, the mutex and conditions are only touched when a side has to block.
+   *
+   * Copy, move, swap and assignment are not synchronized. They require that no other thread uses either queue
+   * meanwhile, use the locked policy to copy a queue in use.
+   */
+  struct spsc
+    {
+    using default_layout = queue_layout::padded;
+    };
+
+  /**
+   * Any number of producers and consumers. Positions are claimed with compare-and-swap, every slot carries a
+   * sequence number telling whether it is ready to be written or read.
+   *
+   * As with spsc, copy, move, swap and assignment require that no other thread uses either queue meanwhile.
+   */
+  struct mpmc
+    {
+    using default_layout = queue_layout::padded;
+    };
+  }
+
+namespace queue_statistics
+  {
+  constexpr std::size_t occupancy_buckets{8};
+
+  /**
+   * Bucket i of the occupancy histogram counts the operations after which between i and i + 1 eighths of the
+   * capacity were occupied, the last bucket includes a full queue. Wait times only include threads that blocked.
+   */
+  struct snapshot
+    {
+    using size_type = std::size_t;
+    using duration = std::chrono::steady_clock::duration;
+
+    size_type pushes{};
+    size_type pops{};
+    size_type blockedPushes{};
+    size_type blockedPops{};
+    duration pushWaitTime{};
+    duration popWaitTime{};
+    size_type pushTimeouts{};
+    size_type popTimeouts{};
+    size_type highWaterMark{};
+    std::array<size_type, occupancy_buckets> occupancy{};
+    };
+
+  /**
+   * Records nothing, all hooks are empty and no clock is read.
+   */
+  struct disabled
+    {
+    static constexpr bool recording{false};
+
+    struct recorder
+      {
+      struct wait_timer
+        {
+        bool check(bool const ready) noexcept
+          {
+          return ready;
+          }
+        };
+
+      void pushed(std::size_t, std::size_t, std::size_t) noexcept
+        {
+
+        }
+
+      void popped(std::size_t, std::size_t, std::size_t) noexcept
+        {
+
+        }
+
+      void blocked_push(wait_timer const &, bool) noexcept
+        {
+
+        }
+
+      void blocked_pop(wait_timer const &, bool) noexcept
+        {
+
+        }
+      };
+    };
+
+  /**
+   * Records every operation. The hooks run under the queue lock, so the counters are plain integers, and the
+   * clock is only read by threads that are about to block anyway.
+   */
+  struct enabled
+    {
+    static constexpr bool recording{true};
+
+    struct recorder
+      {
+      using __clock = std::chrono::steady_clock;
+
+      /*
+       * Starts when a wait predicate fails for the first time.
+       */
+      struct wait_timer
+        {
+        bool check(bool const ready) noexcept
+          {
+          if(!ready && !blocked)
+            {
+            blocked = true;
+            start = __clock::now();
+            }
+
+          return ready;
+          }
+
+        bool blocked{};
+        __clock::time_point start{};
+        };
+
+      void pushed(std::size_t const count, std::size_t const size, std::size_t const capacity) noexcept
+        {
+        if(count)
+          {
+          m_snapshot.pushes += count;
+          m_snapshot.highWaterMark = std::max(m_snapshot.highWaterMark, size);
+          record_occupancy(size, capacity);
+          }
+        }
+
+      void popped(std::size_t const count, std::size_t const size, std::size_t const capacity) noexcept
+        {
+        if(count)
+          {
+          m_snapshot.pops += count;
+          record_occupancy(size, capacity);
+          }
+        }
+
+      void blocked_push(wait_timer const & timer, bool const ready) noexcept
+        {
+        if(timer.blocked)
+          {
+          ++m_snapshot.blockedPushes;
+          m_snapshot.pushWaitTime += __clock::now() - timer.start;
+          m_snapshot.pushTimeouts += !ready;
+          }
+        }
+
+      void blocked_pop(wait_timer const & timer, bool const ready) noexcept
+        {
+        if(timer.blocked)
+          {
+          ++m_snapshot.blockedPops;
+          m_snapshot.popWaitTime += __clock::now() - timer.start;
+          m_snapshot.popTimeouts += !ready;
+          }
+        }
+
+      snapshot const & get() const noexcept
+        {
+        return m_snapshot;
+        }
+
+      private:
+        void record_occupancy(std::size_t const size, std::size_t const capacity) noexcept
+          {
+          ++m_snapshot.occupancy[std::min(size * occupancy_buckets / capacity, occupancy_buckets - 1)];
+          }
+
+        snapshot m_snapshot{};
+      };
+    };
+  }
+
+namespace queue_detail
+  {
+  template<typename ActionType>
+  struct scope_exit
+    {
+    ~scope_exit()
+      {
+      action();
+      }
+
+    ActionType & action;
+    };
+
+  /**
+   * Runs finish after operation, also when operation throws. Unlike scope_exit, finish does not run in a
+   * destructor, so it may throw itself without terminating the program while the exception of operation unwinds.
+   */
+  template<typename FinishType, typename OperationType>
+  auto finish_after(FinishType && finish, OperationType && operation)
+    {
+    try
+      {
+      operation();
+      }
+    catch(...)
+      {
+      finish();
+      throw;
+      }
+
+    finish();
+    }
+
+  /**
+   * The lock-free policies use free-running positions. For power-of-two capacities the position is mapped to a
+   * slot by masking instead of a division.
+   */
+  constexpr auto index_mask(std::size_t const size) noexcept
+    {
+    return size > 1 && !(size & (size - 1)) ? size - 1 : 0;
+    }
+
+  /**
+   * A value that is only changed under a lock but may be read without it. It is changed by a relaxed load and
+   * store, the lock already orders the writers, so it costs no more than a plain size_type on the hot path.
+   */
+  template<typename ValueType>
+  struct published
+    {
+    published(ValueType const value = {}) noexcept
+      : m_value{value}
+      {
+
+      }
+
+    published(published const & other) noexcept
+      : published{other.load()}
+      {
+
+      }
+
+    published & operator=(published const & other) noexcept
+      {
+      store(other.load());
+      return *this;
+      }
+
+    operator ValueType() const noexcept
+      {
+      return load();
+      }
+
+    ValueType load() const noexcept
+      {
+      return m_value.load(std::memory_order_relaxed);
+      }
+
+    published & operator++() noexcept
+      {
+      store(load() + 1);
+      return *this;
+      }
+
+    published & operator--() noexcept
+      {
+      store(load() - 1);
+      return *this;
+      }
+
+    ValueType operator++(int) noexcept
+      {
+      auto const value = load();
+      store(value + 1);
+      return value;
+      }
+
+    private:
+      auto store(ValueType const value) noexcept
+        {
+        m_value.store(value, std::memory_order_relaxed);
+        }
+
+      std::atomic<ValueType> m_value;
+    };
+
+  /**
+   * Like the standard containers, a queue keeps its allocator on swap, copy and move assignment unless the
+   * allocator asks to be propagated. Allocators that do not propagate have to compare equal for swap, move
+   * assignment moves the elements one by one if they do not.
+   */
+  template<typename AllocatorType>
+  auto swap_allocators(AllocatorType & first, AllocatorType & second, std::true_type)
+    {
+    using std::swap;
+    swap(first, second);
+    }
+
+  template<typename AllocatorType>
+  auto swap_allocators(AllocatorType &, AllocatorType &, std::false_type) noexcept
+    {
+
+    }
+
+  template<typename AllocatorType>
+  decltype(auto) copy_assignment_allocator(AllocatorType const & target, AllocatorType const & source) noexcept
+    {
+    return std::allocator_traits<AllocatorType>::propagate_on_container_copy_assignment::value ? source : target;
+    }
+
+  /**
+   * The storage allocator is rebound to the element type, so allocators with their own construct() and destroy(),
+   * like the polymorphic ones, see every element.
+   */
+  template<typename ValueType, typename AllocatorType, typename... ArgumentTypes>
+  auto construct_element(AllocatorType const & allocator, ValueType * const target, ArgumentTypes && ... arguments)
+    {
+    using element_allocator = typename std::allocator_traits<AllocatorType>::template rebind_alloc<ValueType>;
+
+    element_allocator elements{allocator};
+    std::allocator_traits<element_allocator>::construct(elements, target, std::forward<ArgumentTypes>(arguments)...);
+    }
+
+  template<typename ValueType, typename AllocatorType>
+  auto destroy_element(AllocatorType const & allocator, ValueType * const target) noexcept
+    {
+    using element_allocator = typename std::allocator_traits<AllocatorType>::template rebind_alloc<ValueType>;
+
+    element_allocator elements{allocator};
+    std::allocator_traits<element_allocator>::destroy(elements, target);
+    }
+
+  /**
+   * Blocking support for the lock-free queue policies. A thread only takes the mutex when it is about to sleep,
+   * or when the other side has announced that somebody sleeps.
+   *
+   * The waiter count is published before the queue state is re-checked, and the waker publishes the queue state
+   * before it reads the waiter count. The two sequentially consistent fences guarantee that at least one side
+   * sees the other, so no sleeping thread misses its wake-up.
+   */
+  template<typename MutexType, typename ConditionType>
+  struct parking
+    {
+    using __guard = std::lock_guard<MutexType>;
+    using __ulock = std::unique_lock<MutexType>;
+    using __waiters = std::atomic<unsigned>;
+
+    template<typename PredicateType>
+    auto wait_for_space(PredicateType && ready)
+      {
+      park(m_producersWaiting, [&](__ulock & ulock){ m_hasSpace.wait(ulock, ready); return true; });
+      }
+
+    template<typename PredicateType, typename RepresentationType, typename Period>
+    auto wait_for_space(PredicateType && ready, std::chrono::duration<RepresentationType, Period> const & timeout)
+      {
+      return park(m_producersWaiting, [&](__ulock & ulock){ return m_hasSpace.wait_for(ulock, timeout, ready); });
+      }
+
+    template<typename PredicateType>
+    auto wait_for_elements(PredicateType && ready)
+      {
+      park(m_consumersWaiting, [&](__ulock & ulock){ m_hasElements.wait(ulock, ready); return true; });
+      }
+
+    template<typename PredicateType, typename RepresentationType, typename Period>
+    auto wait_for_elements(PredicateType && ready, std::chrono::duration<RepresentationType, Period> const & timeout)
+      {
+      return park(m_consumersWaiting, [&](__ulock & ulock){ return m_hasElements.wait_for(ulock, timeout, ready); });
+      }
+
+    auto wake_producer()
+      {
+      wake(m_producersWaiting, m_hasSpace);
+      }
+
+    auto wake_consumer()
+      {
+      wake(m_consumersWaiting, m_hasElements);
+      }
+
+    auto wake_all()
+      {
+        {
+        __guard guard{m_mutex};
+        }
+
+      m_hasSpace.notify_all();
+      m_hasElements.notify_all();
+      }
+
+    private:
+      template<typename WaitOperation>
+      auto park(__waiters & waiting, WaitOperation && wait)
+        {
+        __ulock ulock{m_mutex};
+        waiting.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        auto const ready = wait(ulock);
+
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+        return ready;
+        }
+
+      auto wake(__waiters const & waiting, ConditionType & condition)
+        {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(waiting.load(std::memory_order_relaxed))
+          {
+            {
+            __guard guard{m_mutex};
+            }
+
+          condition.notify_one();
+          }
+        }
+
+      MutexType m_mutex{};
+      ConditionType m_hasSpace{};
+      ConditionType m_hasElements{};
+      __waiters m_producersWaiting{};
+      __waiters m_consumersWaiting{};
+    };
+  }
+
+template<typename ValueType,
+         typename MutexType = std::mutex,
+         typename ConditionType = std::condition_variable,
+         typename SynchronizationPolicy = queue_policy::locked,
+         typename LayoutPolicy = typename SynchronizationPolicy::default_layout,
+         typename StatisticsPolicy = queue_statistics::disabled,
+         typename AllocatorType = std::allocator<ValueType>>
 struct BoundedQueue
   {
+  static_assert(!StatisticsPolicy::recording || std::is_same<SynchronizationPolicy, queue_policy::locked>::value,
+                "Statistics are only recorded by the locked policy");
+
   using value_type      = ValueType;
   using reference       = value_type &;
   using const_reference = value_type const &;
   using pointer         = value_type *;
   using const_pointer   = value_type const *;
   using size_type       = std::size_t;
+  using allocator_type  = AllocatorType;
 
   using __mutex = MutexType;
   using __condition = ConditionType;
   using __guard = std::lock_guard<__mutex>;
   using __ulock = std::unique_lock<__mutex>;
+  using __storage = std::aligned_storage_t<sizeof(value_type), alignof(value_type)>;
+  using __allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<__storage>;
+  using __allocator_traits = std::allocator_traits<__allocator>;
+  using __wait_timer = typename StatisticsPolicy::recorder::wait_timer;
 
-  BoundedQueue(size_type const size)
+  BoundedQueue(size_type const size, allocator_type const & allocator = allocator_type{})
     : m_maximumSize{size ? size : throw std::invalid_argument{"Tried to allocate BoundedQueue of size 0"}},
-      m_data{new char[size * sizeof(ValueType)]}
+      m_allocator{allocator},
+      m_data{__allocator_traits::allocate(m_allocator, size)}
     {
 
     }
 
   BoundedQueue(BoundedQueue const & other)
-    : BoundedQueue{other.m_maximumSize}
+    : BoundedQueue{other, __allocator_traits::select_on_container_copy_construction(other.m_allocator)}
+    {
+
+    }
+
+  BoundedQueue(BoundedQueue const & other, allocator_type const & allocator)
+    : BoundedQueue{other.m_maximumSize, allocator}
     {
     __guard guard{other.m_mutex};
 
@@ -39,71 +536,123 @@ struct BoundedQueue
       {
       do_push(*(other.ptr() + other.to_buffer_index(index)));
       }
+
+    m_closed = other.m_closed;
     }
 
   BoundedQueue(BoundedQueue && other)
+    : m_allocator{other.m_allocator}
     {
     swap(other);
     }
 
+  /**
+   * Moves the elements one by one into storage from allocator.
+   */
+  BoundedQueue(BoundedQueue && other, allocator_type const & allocator)
+    : BoundedQueue{other.m_maximumSize, allocator}
+    {
+    __guard guard{other.m_mutex};
+
+    for(std::size_t index{}; index < other.m_size; ++index)
+      {
+      do_push(std::move(*(other.ptr() + other.to_buffer_index(index))));
+      }
+
+    m_closed = other.m_closed;
+    }
+
   ~BoundedQueue()
     {
     while(!do_empty())
       {
-      (ptr() + m_first)->~value_type();
-      m_first = (m_first + 1) % m_maximumSize;
-      --m_size;
+      drop_front();
       }
 
-    delete[](m_data);
+    if(m_data)
+      {
+      __allocator_traits::deallocate(m_allocator, m_data, m_maximumSize);
+      }
     }
 
-  auto empty() const
+  /**
+   * The observers do not lock, so polling them does not contend with producers and consumers. They return a
+   * snapshot that may already be outdated when it is returned. The capacity is published like the size, because
+   * swap() and assignment change it under the lock.
+   */
+  auto empty() const noexcept
     {
-    __guard guard{m_mutex};
     return do_empty();
     }
 
-  auto full() const
+  auto full() const noexcept
     {
-    __guard guard{m_mutex};
     return do_full();
     }
 
-  auto size() const
+  size_type size() const noexcept
     {
-    __guard guard{m_mutex};
     return m_size;
     }
 
+  auto closed() const
+    {
+    __guard guard{m_mutex};
+    return m_closed;
+    }
+
+  /**
+   * Wakes all waiting threads. Afterwards pushes fail, while consumers drain the remaining elements before the
+   * queue reports the end of the stream.
+   */
+  auto close()
+    {
+    __ulock ulock{m_mutex};
+    m_closed = true;
+
+    notify(m_hasSpace, m_producersWaiting);
+    notify(m_hasElements, m_consumersWaiting);
+    resume(m_asyncProducers, m_asyncProducers.size());
+    resume(m_asyncConsumers, m_asyncConsumers.size());
+    observe_readiness();
+
+    unlock_and_resume(ulock);
+    }
+
   auto push(value_type const & elem)
     {
     __ulock ulock{m_mutex};
-    m_hasSpace.wait(ulock, [&]{ return !do_full(); });
+    wait_for_space(ulock, [&]{ return push_ready(); });
+    throw_if_closed();
 
     do_push(elem);
 
-    m_hasElements.notify_one();
+    signal_consumers();
+    unlock_and_resume(ulock);
     }
 
   auto push(value_type && elem)
     {
     __ulock ulock{m_mutex};
-    m_hasSpace.wait(ulock, [&]{ return !do_full(); });
+    wait_for_space(ulock, [&]{ return push_ready(); });
+    throw_if_closed();
 
     do_push(std::move(elem));
 
-    m_hasElements.notify_one();
+    signal_consumers();
+    unlock_and_resume(ulock);
     }
 
   value_type pop()
     {
     __ulock ulock{m_mutex};
-    m_hasElements.wait(ulock, [&]{ return !do_empty(); });
+    wait_for_elements(ulock, [&]{ return pop_ready(); });
+    throw_if_drained();
 
     auto temporary = do_pop();
 
-    m_hasSpace.notify_one();
+    signal_producers();
+    unlock_and_resume(ulock);
 
     return temporary;
     }
@@ -111,43 +660,58 @@ struct BoundedQueue
   auto try_push(value_type const & elem)
     {
     __ulock ulock{m_mutex};
-    if(do_full())
+    if(m_closed || do_full())
       {
       return false;
       }
 
     do_push(elem);
 
-    m_hasElements.notify_one();
+    signal_consumers();
+    unlock_and_resume(ulock);
     return true;
     }
 
   auto try_push(value_type && elem)
     {
-    __guard guard{m_mutex};
-    if(do_full())
+    __ulock ulock{m_mutex};
+    if(m_closed || do_full())
       {
       return false;
       }
 
     do_push(std::move(elem));
 
-    m_hasElements.notify_one();
+    signal_consumers();
+    unlock_and_resume(ulock);
     return true;
     }
 
   template<typename RepresentationType, typename Period>
   auto try_push_for(value_type const & elem, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return try_emplace_for(timeout, elem);
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_push_for(value_type && elem, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return try_emplace_for(timeout, std::move(elem));
+    }
+
+  template<typename RepresentationType, typename Period, typename... ArgumentTypes>
+  auto try_emplace_for(std::chrono::duration<RepresentationType, Period> const & timeout, ArgumentTypes && ... arguments)
     {
     __ulock ulock{m_mutex};
-    if(!m_hasSpace.wait_for(ulock, timeout, [&]{ return !do_full(); }))
+    if(!wait_for_space(ulock, timeout, [&]{ return push_ready(); }) || m_closed)
       {
       return false;
       }
 
-    do_push(elem);
+    do_emplace(std::forward<ArgumentTypes>(arguments)...);
 
-    m_hasElements.notify_one();
+    signal_consumers();
+    unlock_and_resume(ulock);
 
     return true;
     }
@@ -156,18 +720,38 @@ struct BoundedQueue
   auto try_pop_for(value_type & target, std::chrono::duration<RepresentationType, Period> const & timeout)
     {
     __ulock ulock{m_mutex};
-    if(!m_hasElements.wait_for(ulock, timeout, [&]{ return !do_empty(); }))
+    if(!wait_for_elements(ulock, timeout, [&]{ return pop_ready(); }) || do_empty())
       {
       return false;
       }
 
     target = do_pop();
 
-    m_hasSpace.notify_one();
+    signal_producers();
+    unlock_and_resume(ulock);
 
     return true;
     }
 
+  /**
+   * Moves the front element straight into the result, so value_type needs neither a default constructor nor
+   * move assignment. The result is empty if no element arrived in time.
+   */
+  template<typename RepresentationType, typename Period>
+  auto try_pop_for(std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    __ulock ulock{m_mutex};
+    boost::optional<value_type> element{};
+
+    if(wait_for_elements(ulock, timeout, [&]{ return pop_ready(); }) && !do_empty())
+      {
+      take_front(element);
+      }
+
+    unlock_and_resume(ulock);
+    return element;
+    }
+
   auto try_pop(value_type & target)
     {
     __ulock ulock{m_mutex};
@@ -178,90 +762,610 @@ struct BoundedQueue
 
     target = do_pop();
 
-    m_hasSpace.notify_one();
+    signal_producers();
+    unlock_and_resume(ulock);
 
     return true;
     }
 
-  auto swap(BoundedQueue & other)
+  auto try_pop()
     {
-    __ulock theirs{other.m_mutex, std::defer_lock};
-    __ulock ours{m_mutex, std::defer_lock};
-    std::lock(ours, theirs);
-
-    std::swap(m_maximumSize, other.m_maximumSize);
-    std::swap(m_first, other.m_first);
-    std::swap(m_size, other.m_size);
-    std::swap(m_data, other.m_data);
-    }
+    __ulock ulock{m_mutex};
+    boost::optional<value_type> element{};
 
-  decltype(auto) operator=(BoundedQueue const & other)
-    {
-    if(this != &other)
+    if(!do_empty())
       {
-      BoundedQueue temporary{other};
-      swap(temporary);
+      take_front(element);
       }
 
-    return *this;
+    unlock_and_resume(ulock);
+    return element;
     }
 
-  decltype(auto) operator=(BoundedQueue && other)
+  template<typename... ArgumentTypes>
+  auto emplace(ArgumentTypes && ... arguments)
     {
-    if(this != &other)
-      {
-      swap(other);
-      }
+    __ulock ulock{m_mutex};
+    wait_for_space(ulock, [&]{ return push_ready(); });
+    throw_if_closed();
 
-    return *this;
+    do_emplace(std::forward<ArgumentTypes>(arguments)...);
+
+    signal_consumers();
+    unlock_and_resume(ulock);
     }
 
-  private:
-    auto do_empty() const noexcept
+  template<typename... ArgumentTypes>
+  auto try_emplace(ArgumentTypes && ... arguments)
+    {
+    __ulock ulock{m_mutex};
+    if(m_closed || do_full())
       {
-      return !m_size;
+      return false;
       }
 
-    auto do_full() const noexcept
-      {
-      return m_size == m_maximumSize;
-      }
+    do_emplace(std::forward<ArgumentTypes>(arguments)...);
+
+    signal_consumers();
+    unlock_and_resume(ulock);
+    return true;
+    }
 
-    auto do_push(value_type const & element) noexcept(noexcept(new (nullptr) value_type{element}))
+  /**
+   * Hands the front element to the consumer in place and removes it afterwards, even if the consumer throws.
+   * The consumer runs while the queue lock is held. Returns false once the queue is closed and drained.
+   */
+  template<typename ConsumerType>
+  auto consume(ConsumerType && consumer)
+    {
+    __ulock ulock{m_mutex};
+    wait_for_elements(ulock, [&]{ return pop_ready(); });
+    if(do_empty())
       {
-      new (ptr() + push_index()) value_type{element};
+      return false;
       }
 
-    auto do_push(value_type && element) noexcept(noexcept(new (nullptr) value_type{std::move(element)}))
+    queue_detail::finish_after([&]{ unlock_and_resume(ulock); }, [&]{ do_consume(std::forward<ConsumerType>(consumer)); });
+    return true;
+    }
+
+  template<typename ConsumerType>
+  auto try_consume(ConsumerType && consumer)
+    {
+    __ulock ulock{m_mutex};
+    if(do_empty())
       {
-      new (ptr() + push_index()) value_type{std::move(element)};
+      return false;
       }
 
-    value_type do_pop() noexcept(noexcept(std::declval<value_type &>() = std::declval<value_type>()) && noexcept(value_type{std::declval<value_type>()}))
-      {
-      auto temporary = std::move(*(ptr() + m_first));
-      (ptr() + m_first)->~value_type();
+    queue_detail::finish_after([&]{ unlock_and_resume(ulock); }, [&]{ do_consume(std::forward<ConsumerType>(consumer)); });
+    return true;
+    }
 
-      m_first = (m_first + 1) % m_maximumSize;
-      --m_size;
+  template<typename InputIterator>
+  auto push_range(InputIterator first, InputIterator const last)
+    {
+    __ulock ulock{m_mutex};
 
-      return temporary;
-      }
+    queue_detail::finish_after([&]{ unlock_and_resume(ulock); }, [&]{
+      while(first != last)
+        {
+        wait_for_space(ulock, [&]{ return push_ready(); });
+        throw_if_closed();
 
-    auto back_index() const noexcept
-      {
-      return to_buffer_index(m_size - 1);
-      }
+        first = do_push_range(first, last);
+        }
+    });
+    }
 
-    auto push_index() noexcept
-      {
-      return to_buffer_index(m_size++);
-      }
+  template<typename InputIterator>
+  auto try_push_range(InputIterator const first, InputIterator const last)
+    {
+    __ulock ulock{m_mutex};
+    auto rest = first;
 
-    auto to_buffer_index(size_type const index) const noexcept
-      {
-      return (m_first + index) % m_maximumSize;
-      }
+    queue_detail::finish_after([&]{ unlock_and_resume(ulock); }, [&]{ rest = do_push_range(first, last); });
+    return rest;
+    }
+
+  template<typename InputIterator, typename RepresentationType, typename Period>
+  auto try_push_range_for(InputIterator first, InputIterator const last, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    auto const deadline = std::chrono::steady_clock::now() + timeout;
+    __ulock ulock{m_mutex};
+
+    queue_detail::finish_after([&]{ unlock_and_resume(ulock); }, [&]{
+      while(first != last)
+        {
+        auto const now = std::chrono::steady_clock::now();
+
+        if(do_full() && (now >= deadline || !wait_for_space(ulock, deadline - now, [&]{ return push_ready(); })))
+          {
+          break;
+          }
+
+        if(m_closed)
+          {
+          break;
+          }
+
+        first = do_push_range(first, last);
+        }
+    });
+
+    return first;
+    }
+
+  template<typename OutputIterator>
+  auto pop_into(OutputIterator target, size_type const maximumCount)
+    {
+    if(!maximumCount)
+      {
+      return size_type{};
+      }
+
+    __ulock ulock{m_mutex};
+    wait_for_elements(ulock, [&]{ return pop_ready(); });
+
+    auto count = size_type{};
+
+    queue_detail::finish_after([&]{ unlock_and_resume(ulock); }, [&]{ count = do_pop_into(target, maximumCount); });
+    return count;
+    }
+
+  template<typename OutputIterator>
+  auto try_pop_into(OutputIterator target, size_type const maximumCount)
+    {
+    __ulock ulock{m_mutex};
+    auto count = size_type{};
+
+    queue_detail::finish_after([&]{ unlock_and_resume(ulock); }, [&]{ count = do_pop_into(target, maximumCount); });
+    return count;
+    }
+
+  template<typename OutputIterator, typename RepresentationType, typename Period>
+  auto try_pop_into_for(OutputIterator target, size_type const maximumCount, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    __ulock ulock{m_mutex};
+    if(!maximumCount || !wait_for_elements(ulock, timeout, [&]{ return pop_ready(); }))
+      {
+      return size_type{};
+      }
+
+    auto count = size_type{};
+
+    queue_detail::finish_after([&]{ unlock_and_resume(ulock); }, [&]{ count = do_pop_into(target, maximumCount); });
+    return count;
+    }
+
+  /**
+   * Pops without blocking a thread. Every attempt runs as a task of the executor, which has to provide
+   * submit(std::function<void()>). While the queue is empty the attempt is parked inside the queue and submitted
+   * again once an element arrives. The handler receives the element, or none once the queue is closed and drained.
+   *
+   * Parked attempts are submitted after the queue lock is released, so submit() may block. Close the queue and
+   * let all parked operations finish before destroying it.
+   */
+  template<typename ExecutorType, typename HandlerType>
+  void async_pop(ExecutorType & executor, HandlerType handler)
+    {
+    executor.submit([this, &executor, handler]() mutable { do_async_pop(executor, handler); });
+    }
+
+  /**
+   * The counterpart of async_pop(). The handler receives false if the queue was closed before the element found
+   * a free slot.
+   */
+  template<typename ExecutorType, typename HandlerType>
+  void async_push(value_type elem, ExecutorType & executor, HandlerType handler)
+    {
+    auto pending = std::make_shared<value_type>(std::move(elem));
+    executor.submit([this, &executor, pending, handler]() mutable { do_async_push(pending, executor, handler); });
+    }
+
+  /**
+   * Registers an observer that is told whenever the queue starts or stops having something for a consumer, which
+   * is an element or the end of the stream. The observer is called right away with the current state, and later
+   * only on changes, always while the queue lock is held. An empty function removes the observer. A queue has a
+   * single observer, registering a second one without removing the first throws std::logic_error.
+   */
+  auto observe(std::function<void(bool)> observer)
+    {
+    __guard guard{m_mutex};
+    if(observer && m_observer) throw std::logic_error{"Tried to register a second observer of BoundedQueue"};
+
+    m_observer = std::move(observer);
+
+    if(m_observer)
+      {
+      m_observedReady = pop_ready();
+      m_observer(m_observedReady);
+      }
+    }
+
+  /**
+   * A consistent copy of the counters, only available with queue_statistics::enabled. The counters belong to the
+   * queue object, they are neither copied nor swapped with its elements.
+   */
+  auto statistics() const
+    {
+    static_assert(StatisticsPolicy::recording, "BoundedQueue statistics are disabled");
+
+    __guard guard{m_mutex};
+    return m_statistics.get();
+    }
+
+  auto get_allocator() const
+    {
+    return allocator_type{m_allocator};
+    }
+
+  auto swap(BoundedQueue & other)
+    {
+    do_swap(other, typename __allocator_traits::propagate_on_container_swap{});
+    }
+
+  decltype(auto) operator=(BoundedQueue const & other)
+    {
+    if(this != &other)
+      {
+      BoundedQueue temporary{other, queue_detail::copy_assignment_allocator(m_allocator, other.m_allocator)};
+      do_swap(temporary, typename __allocator_traits::propagate_on_container_copy_assignment{});
+      }
+
+    return *this;
+    }
+
+  decltype(auto) operator=(BoundedQueue && other)
+    {
+    if(this != &other)
+      {
+      move_assign(other, typename __allocator_traits::propagate_on_container_move_assignment{});
+      }
+
+    return *this;
+    }
+
+  private:
+    /*
+     * Exchanges the contents, the allocators only if Propagate says so. Otherwise they have to compare equal, or
+     * the storage has to come from the allocator this queue keeps.
+     */
+    template<typename Propagate>
+    auto do_swap(BoundedQueue & other, Propagate const propagate)
+      {
+      __ulock theirs{other.m_mutex, std::defer_lock};
+      __ulock ours{m_mutex, std::defer_lock};
+      std::lock(ours, theirs);
+
+      std::swap(m_maximumSize, other.m_maximumSize);
+      queue_detail::swap_allocators(m_allocator, other.m_allocator, propagate);
+      std::swap(m_first, other.m_first);
+      std::swap(m_size, other.m_size);
+      std::swap(m_data, other.m_data);
+      std::swap(m_closed, other.m_closed);
+
+      observe_readiness();
+      other.observe_readiness();
+      }
+
+    auto move_assign(BoundedQueue & other, std::true_type)
+      {
+      do_swap(other, std::true_type{});
+      }
+
+    auto move_assign(BoundedQueue & other, std::false_type)
+      {
+      if(m_allocator == other.m_allocator)
+        {
+        do_swap(other, std::false_type{});
+        return;
+        }
+
+      BoundedQueue temporary{std::move(other), get_allocator()};
+      do_swap(temporary, std::false_type{});
+      }
+
+    auto do_empty() const noexcept
+      {
+      return !m_size;
+      }
+
+    auto do_full() const noexcept
+      {
+      return m_size == m_maximumSize;
+      }
+
+    auto push_ready() const noexcept
+      {
+      return m_closed || !do_full();
+      }
+
+    auto pop_ready() const noexcept
+      {
+      return m_closed || !do_empty();
+      }
+
+    auto throw_if_closed() const
+      {
+      if(m_closed) throw queue_closed{"Tried to push to a closed BoundedQueue"};
+      }
+
+    auto throw_if_drained() const
+      {
+      if(do_empty()) throw queue_closed{"BoundedQueue is closed and drained"};
+      }
+
+    auto do_push(value_type const & element)
+      {
+      do_emplace(element);
+      }
+
+    auto do_push(value_type && element)
+      {
+      do_emplace(std::move(element));
+      }
+
+    template<typename... ArgumentTypes>
+    auto do_emplace(ArgumentTypes && ... arguments)
+      {
+      queue_detail::construct_element(m_allocator, ptr() + to_buffer_index(m_size), std::forward<ArgumentTypes>(arguments)...);
+      ++m_size;
+      }
+
+    value_type do_pop() noexcept(noexcept(std::declval<value_type &>() = std::declval<value_type>()) && noexcept(value_type{std::declval<value_type>()}))
+      {
+      auto temporary = std::move(*(ptr() + m_first));
+      drop_front();
+
+      return temporary;
+      }
+
+    auto take_front(boost::optional<value_type> & element)
+      {
+      element.emplace(std::move(*(ptr() + m_first)));
+      drop_front();
+
+      signal_producers();
+      }
+
+    template<typename ConsumerType>
+    auto do_consume(ConsumerType && consumer)
+      {
+      auto finish = [&]{
+        drop_front();
+        signal_producers();
+      };
+
+      queue_detail::finish_after(finish, [&]{ std::forward<ConsumerType>(consumer)(*(ptr() + m_first)); });
+      }
+
+    auto drop_front() noexcept
+      {
+      queue_detail::destroy_element(m_allocator, ptr() + m_first);
+
+      m_first = to_buffer_index(1);
+      --m_size;
+      }
+
+    template<typename InputIterator>
+    auto do_push_range(InputIterator first, InputIterator const last)
+      {
+      size_type const previousSize = m_size;
+
+      queue_detail::finish_after([&]{ signal_consumers(m_size - previousSize); }, [&]{
+        for(; first != last && !m_closed && !do_full(); ++first)
+          {
+          do_push(*first);
+          }
+      });
+
+      return first;
+      }
+
+    /*
+     * An element whose transfer to target throws is lost, but its slot is free like those popped before, so the
+     * producers are signalled for every slot either way.
+     */
+    template<typename OutputIterator>
+    auto do_pop_into(OutputIterator & target, size_type const maximumCount)
+      {
+      size_type const previousSize = m_size;
+      auto const count = std::min<size_type>(m_size, maximumCount);
+
+      queue_detail::finish_after([&]{ signal_producers(previousSize - m_size); }, [&]{
+        for(size_type popped{}; popped < count; ++popped)
+          {
+          *target++ = do_pop();
+          }
+      });
+
+      return count;
+      }
+
+    /*
+     * Waiting threads register themselves under the lock, so a notification only has to be sent while someone
+     * waits, and never to more threads than there are new elements or free slots. The wait timer only starts when
+     * the predicate fails, so only threads that actually block are recorded.
+     */
+    template<typename PredicateType>
+    auto wait_for_space(__ulock & ulock, PredicateType && ready)
+      {
+      __wait_timer timer{};
+      await(ulock, m_producersWaiting, [&]{ m_hasSpace.wait(ulock, [&]{ return timer.check(ready()); }); return true; });
+      m_statistics.blocked_push(timer, true);
+      }
+
+    template<typename RepresentationType, typename Period, typename PredicateType>
+    auto wait_for_space(__ulock & ulock, std::chrono::duration<RepresentationType, Period> const & timeout, PredicateType && ready)
+      {
+      __wait_timer timer{};
+      auto const isReady = await(ulock, m_producersWaiting, [&]{ return m_hasSpace.wait_for(ulock, timeout, [&]{ return timer.check(ready()); }); });
+      m_statistics.blocked_push(timer, isReady);
+
+      return isReady;
+      }
+
+    template<typename PredicateType>
+    auto wait_for_elements(__ulock & ulock, PredicateType && ready)
+      {
+      __wait_timer timer{};
+      await(ulock, m_consumersWaiting, [&]{ m_hasElements.wait(ulock, [&]{ return timer.check(ready()); }); return true; });
+      m_statistics.blocked_pop(timer, true);
+      }
+
+    template<typename RepresentationType, typename Period, typename PredicateType>
+    auto wait_for_elements(__ulock & ulock, std::chrono::duration<RepresentationType, Period> const & timeout, PredicateType && ready)
+      {
+      __wait_timer timer{};
+      auto const isReady = await(ulock, m_consumersWaiting, [&]{ return m_hasElements.wait_for(ulock, timeout, [&]{ return timer.check(ready()); }); });
+      m_statistics.blocked_pop(timer, isReady);
+
+      return isReady;
+      }
+
+    /*
+     * Attempts this thread resumed before, e.g. between the rounds of push_range(), may be the ones that would make
+     * the queue ready, so they are submitted before the thread blocks.
+     */
+    template<typename WaitOperation>
+    auto await(__ulock & ulock, size_type & waiting, WaitOperation && wait)
+      {
+      if(!m_resumed.empty())
+        {
+        unlock_and_resume(ulock);
+        ulock.lock();
+        }
+
+      ++waiting;
+      auto leave = [&]{ --waiting; };
+      queue_detail::scope_exit<decltype(leave)> guard{leave};
+
+      return wait();
+      }
+
+    auto signal_producers(size_type const count = 1)
+      {
+      m_statistics.popped(count, m_size, m_maximumSize);
+      notify(m_hasSpace, std::min(count, m_producersWaiting));
+      resume(m_asyncProducers, count);
+      observe_readiness();
+      }
+
+    auto signal_consumers(size_type const count = 1)
+      {
+      m_statistics.pushed(count, m_size, m_maximumSize);
+      notify(m_hasElements, std::min(count, m_consumersWaiting));
+      resume(m_asyncConsumers, count);
+      observe_readiness();
+      }
+
+    auto observe_readiness()
+      {
+      auto const ready = pop_ready();
+
+      if(m_observer && ready != m_observedReady)
+        {
+        m_observedReady = ready;
+        m_observer(ready);
+        }
+      }
+
+    template<typename ExecutorType, typename HandlerType>
+    void do_async_pop(ExecutorType & executor, HandlerType & handler)
+      {
+      __ulock ulock{m_mutex};
+      if(!pop_ready())
+        {
+        m_asyncConsumers.push_back([this, &executor, handler]{ async_pop(executor, handler); });
+        return;
+        }
+
+      if(do_empty())
+        {
+        ulock.unlock();
+        handler(boost::optional<value_type>{});
+        return;
+        }
+
+      auto element = boost::make_optional(do_pop());
+      signal_producers();
+      unlock_and_resume(ulock);
+
+      handler(std::move(element));
+      }
+
+    template<typename ExecutorType, typename HandlerType>
+    void do_async_push(std::shared_ptr<value_type> & pending, ExecutorType & executor, HandlerType & handler)
+      {
+      __ulock ulock{m_mutex};
+      if(!push_ready())
+        {
+        m_asyncProducers.push_back([this, pending, &executor, handler]{
+          executor.submit([this, pending, &executor, handler]() mutable { do_async_push(pending, executor, handler); });
+        });
+        return;
+        }
+
+      auto const pushed = !m_closed;
+      if(pushed)
+        {
+        do_push(std::move(*pending));
+        signal_consumers();
+        }
+
+      unlock_and_resume(ulock);
+      handler(pushed);
+      }
+
+    /*
+     * Resuming an attempt submits it to its executor, which may block until the executor has room. So the attempts
+     * are only moved aside here, and unlock_and_resume() submits them once the queue lock is released.
+     */
+    auto resume(std::list<std::function<void()>> & parked, size_type const count)
+      {
+      auto last = parked.begin();
+      std::advance(last, std::min(count, parked.size()));
+      m_resumed.splice(m_resumed.end(), parked, parked.begin(), last);
+      }
+
+    auto unlock_and_resume(__ulock & ulock)
+      {
+      auto resumed = std::move(m_resumed);
+      m_resumed.clear();
+      ulock.unlock();
+
+      for(auto const & next : resumed)
+        {
+        next();
+        }
+      }
+
+    /*
+     * One notify_one() per new element or free slot, so a batch never wakes more threads than it can serve.
+     */
+    static auto notify(__condition & condition, size_type const count)
+      {
+      for(auto remaining = count; remaining; --remaining)
+        {
+        condition.notify_one();
+        }
+      }
+
+    auto back_index() const noexcept
+      {
+      return to_buffer_index(m_size - 1);
+      }
+
+    /*
+     * Both m_first and index are smaller than m_maximumSize, so a single conditional subtraction wraps the
+     * position without a division.
+     */
+    auto to_buffer_index(size_type const index) const noexcept
+      {
+      auto const position = m_first + index;
+      return position < m_maximumSize ? position : position - m_maximumSize;
+      }
 
     auto ptr() noexcept
       {
@@ -273,15 +1377,1103 @@ struct BoundedQueue
       return reinterpret_cast<const_pointer>(m_data);
       }
 
-    size_type m_maximumSize{};
+    queue_detail::published<size_type> m_maximumSize{};
+    __allocator m_allocator;
+    __storage * m_data{};
+
+    alignas(queue_layout::alignment<LayoutPolicy, __mutex>) __mutex mutable m_mutex{};
     size_type m_first{};
-    size_type m_size{};
-    char * m_data{};
+    queue_detail::published<size_type> m_size{};
+    bool m_closed{};
+    size_type m_producersWaiting{};
+    size_type m_consumersWaiting{};
+    std::list<std::function<void()>> m_asyncProducers{};
+    std::list<std::function<void()>> m_asyncConsumers{};
+    std::list<std::function<void()>> m_resumed{};
+    std::function<void(bool)> m_observer{};
+    bool m_observedReady{};
+    typename StatisticsPolicy::recorder m_statistics{};
 
-    __mutex mutable m_mutex{};
-    __condition m_hasSpace{};
-    __condition m_hasElements{};
+    alignas(queue_layout::alignment<LayoutPolicy, __condition>) __condition m_hasSpace{};
+    alignas(queue_layout::alignment<LayoutPolicy, __condition>) __condition m_hasElements{};
   };
 
-#endif
+template<typename ValueType, typename MutexType, typename ConditionType, typename LayoutPolicy, typename AllocatorType>
+struct BoundedQueue<ValueType, MutexType, ConditionType, queue_policy::spsc, LayoutPolicy, queue_statistics::disabled, AllocatorType>
+  {
+  using value_type      = ValueType;
+  using reference       = value_type &;
+  using const_reference = value_type const &;
+  using pointer         = value_type *;
+  using const_pointer   = value_type const *;
+  using size_type       = std::size_t;
+
+  using allocator_type  = AllocatorType;
+
+  using __index = std::atomic<size_type>;
+  using __parking = queue_detail::parking<MutexType, ConditionType>;
+  using __storage = std::aligned_storage_t<sizeof(value_type), alignof(value_type)>;
+  using __allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<__storage>;
+  using __allocator_traits = std::allocator_traits<__allocator>;
+
+  BoundedQueue(size_type const size, allocator_type const & allocator = allocator_type{})
+    : m_maximumSize{size ? size : throw std::invalid_argument{"Tried to allocate BoundedQueue of size 0"}},
+      m_mask{queue_detail::index_mask(size)},
+      m_allocator{allocator},
+      m_data{__allocator_traits::allocate(m_allocator, size)}
+    {
+
+    }
+
+  BoundedQueue(BoundedQueue const & other)
+    : BoundedQueue{other, __allocator_traits::select_on_container_copy_construction(other.m_allocator)}
+    {
+
+    }
+
+  BoundedQueue(BoundedQueue const & other, allocator_type const & allocator)
+    : BoundedQueue{other.m_maximumSize, allocator}
+    {
+    auto const last = other.m_tail.load(std::memory_order_acquire);
+
+    for(auto index = other.m_head.load(std::memory_order_acquire); index != last; ++index)
+      {
+      do_push(*(other.ptr() + other.to_buffer_index(index)));
+      }
+
+    m_closed.store(other.closed(), std::memory_order_relaxed);
+    }
+
+  BoundedQueue(BoundedQueue && other)
+    : m_allocator{other.m_allocator}
+    {
+    swap(other);
+    }
+
+  /**
+   * Moves the elements one by one into storage from allocator.
+   */
+  BoundedQueue(BoundedQueue && other, allocator_type const & allocator)
+    : BoundedQueue{other.m_maximumSize, allocator}
+    {
+    auto const last = other.m_tail.load(std::memory_order_acquire);
+
+    for(auto index = other.m_head.load(std::memory_order_acquire); index != last; ++index)
+      {
+      do_push(std::move(*(other.ptr() + other.to_buffer_index(index))));
+      }
+
+    m_closed.store(other.closed(), std::memory_order_relaxed);
+    }
+
+  ~BoundedQueue()
+    {
+    auto const last = m_tail.load(std::memory_order_relaxed);
+
+    for(auto index = m_head.load(std::memory_order_relaxed); index != last; ++index)
+      {
+      queue_detail::destroy_element(m_allocator, ptr() + to_buffer_index(index));
+      }
 
+    if(m_data)
+      {
+      __allocator_traits::deallocate(m_allocator, m_data, m_maximumSize);
+      }
+    }
+
+  auto empty() const noexcept
+    {
+    return !size();
+    }
+
+  auto full() const noexcept
+    {
+    return size() == m_maximumSize;
+    }
+
+  size_type size() const noexcept
+    {
+    auto const head = m_head.load(std::memory_order_acquire);
+    return m_tail.load(std::memory_order_acquire) - head;
+    }
+
+  auto closed() const noexcept
+    {
+    return m_closed.load(std::memory_order_acquire);
+    }
+
+  /**
+   * Wakes all waiting threads and makes further pushes fail. Meant to be called by the producer once it is done,
+   * the consumer then drains the remaining elements before it sees the end of the stream.
+   */
+  auto close()
+    {
+    m_closed.store(true, std::memory_order_release);
+    m_parking.wake_all();
+    }
+
+  auto push(value_type const & elem)
+    {
+    wait_for_space();
+    throw_if_closed();
+
+    do_push(elem);
+    }
+
+  auto push(value_type && elem)
+    {
+    wait_for_space();
+    throw_if_closed();
+
+    do_push(std::move(elem));
+    }
+
+  value_type pop()
+    {
+    wait_for_elements();
+    throw_if_drained();
+
+    return do_pop();
+    }
+
+  template<typename... ArgumentTypes>
+  auto emplace(ArgumentTypes && ... arguments)
+    {
+    wait_for_space();
+    throw_if_closed();
+
+    do_push(std::forward<ArgumentTypes>(arguments)...);
+    }
+
+  template<typename... ArgumentTypes>
+  auto try_emplace(ArgumentTypes && ... arguments)
+    {
+    if(closed() || do_full())
+      {
+      return false;
+      }
+
+    do_push(std::forward<ArgumentTypes>(arguments)...);
+    return true;
+    }
+
+  /**
+   * Hands the front element to the consumer in place and removes it afterwards, even if the consumer throws.
+   * Returns false once the queue is closed and drained.
+   */
+  template<typename ConsumerType>
+  auto consume(ConsumerType && consumer)
+    {
+    wait_for_elements();
+    if(do_empty())
+      {
+      return false;
+      }
+
+    do_consume(std::forward<ConsumerType>(consumer));
+    return true;
+    }
+
+  template<typename ConsumerType>
+  auto try_consume(ConsumerType && consumer)
+    {
+    if(do_empty())
+      {
+      return false;
+      }
+
+    do_consume(std::forward<ConsumerType>(consumer));
+    return true;
+    }
+
+  auto try_push(value_type const & elem)
+    {
+    if(closed() || do_full())
+      {
+      return false;
+      }
+
+    do_push(elem);
+    return true;
+    }
+
+  auto try_push(value_type && elem)
+    {
+    if(closed() || do_full())
+      {
+      return false;
+      }
+
+    do_push(std::move(elem));
+    return true;
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_push_for(value_type const & elem, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return try_emplace_for(timeout, elem);
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_push_for(value_type && elem, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return try_emplace_for(timeout, std::move(elem));
+    }
+
+  template<typename RepresentationType, typename Period, typename... ArgumentTypes>
+  auto try_emplace_for(std::chrono::duration<RepresentationType, Period> const & timeout, ArgumentTypes && ... arguments)
+    {
+    if((do_full() && !m_parking.wait_for_space([&]{ return push_ready(); }, timeout)) || closed())
+      {
+      return false;
+      }
+
+    do_push(std::forward<ArgumentTypes>(arguments)...);
+    return true;
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_pop_for(value_type & target, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    if((do_empty() && !m_parking.wait_for_elements([&]{ return pop_ready(); }, timeout)) || do_empty())
+      {
+      return false;
+      }
+
+    target = do_pop();
+    return true;
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_pop_for(std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    boost::optional<value_type> element{};
+
+    if((!do_empty() || m_parking.wait_for_elements([&]{ return pop_ready(); }, timeout)) && !do_empty())
+      {
+      take_front(element);
+      }
+
+    return element;
+    }
+
+  auto try_pop(value_type & target)
+    {
+    if(do_empty())
+      {
+      return false;
+      }
+
+    target = do_pop();
+    return true;
+    }
+
+  auto try_pop()
+    {
+    boost::optional<value_type> element{};
+
+    if(!do_empty())
+      {
+      take_front(element);
+      }
+
+    return element;
+    }
+
+  auto get_allocator() const
+    {
+    return allocator_type{m_allocator};
+    }
+
+  auto swap(BoundedQueue & other)
+    {
+    do_swap(other, typename __allocator_traits::propagate_on_container_swap{});
+    }
+
+  decltype(auto) operator=(BoundedQueue const & other)
+    {
+    if(this != &other)
+      {
+      BoundedQueue temporary{other, queue_detail::copy_assignment_allocator(m_allocator, other.m_allocator)};
+      do_swap(temporary, typename __allocator_traits::propagate_on_container_copy_assignment{});
+      }
+
+    return *this;
+    }
+
+  decltype(auto) operator=(BoundedQueue && other)
+    {
+    if(this != &other)
+      {
+      move_assign(other, typename __allocator_traits::propagate_on_container_move_assignment{});
+      }
+
+    return *this;
+    }
+
+  private:
+    template<typename Propagate>
+    auto do_swap(BoundedQueue & other, Propagate const propagate)
+      {
+      std::swap(m_maximumSize, other.m_maximumSize);
+      std::swap(m_mask, other.m_mask);
+      queue_detail::swap_allocators(m_allocator, other.m_allocator, propagate);
+      std::swap(m_data, other.m_data);
+      exchange(m_head, other.m_head);
+      exchange(m_tail, other.m_tail);
+      exchange(m_closed, other.m_closed);
+
+      m_headCache = m_head.load(std::memory_order_relaxed);
+      m_tailCache = m_tail.load(std::memory_order_relaxed);
+      other.m_headCache = other.m_head.load(std::memory_order_relaxed);
+      other.m_tailCache = other.m_tail.load(std::memory_order_relaxed);
+      }
+
+    auto move_assign(BoundedQueue & other, std::true_type)
+      {
+      do_swap(other, std::true_type{});
+      }
+
+    auto move_assign(BoundedQueue & other, std::false_type)
+      {
+      if(m_allocator == other.m_allocator)
+        {
+        do_swap(other, std::false_type{});
+        return;
+        }
+
+      BoundedQueue temporary{std::move(other), get_allocator()};
+      do_swap(temporary, std::false_type{});
+      }
+
+    /*
+     * Producer side: m_headCache is the last head the producer has seen, the shared head is only reloaded
+     * once the cached value says the ring is full.
+     */
+    auto do_full() noexcept
+      {
+      auto const tail = m_tail.load(std::memory_order_relaxed);
+
+      if(tail - m_headCache < m_maximumSize)
+        {
+        return false;
+        }
+
+      m_headCache = m_head.load(std::memory_order_acquire);
+      return tail - m_headCache == m_maximumSize;
+      }
+
+    /*
+     * Consumer side: the mirror image of do_full() with m_tailCache. The acquire load of m_closed in pop_ready()
+     * makes every element pushed before close() visible, so an empty ring seen afterwards is drained for good.
+     */
+    auto do_empty() noexcept
+      {
+      auto const head = m_head.load(std::memory_order_relaxed);
+
+      if(m_tailCache != head)
+        {
+        return false;
+        }
+
+      m_tailCache = m_tail.load(std::memory_order_acquire);
+      return m_tailCache == head;
+      }
+
+    template<typename... ArgumentTypes>
+    auto do_push(ArgumentTypes && ... arguments)
+      {
+      auto const tail = m_tail.load(std::memory_order_relaxed);
+      queue_detail::construct_element(m_allocator, ptr() + to_buffer_index(tail), std::forward<ArgumentTypes>(arguments)...);
+      m_tail.store(tail + 1, std::memory_order_release);
+
+      m_parking.wake_consumer();
+      }
+
+    value_type do_pop()
+      {
+      auto temporary = std::move(front());
+      drop_front();
+
+      return temporary;
+      }
+
+    auto take_front(boost::optional<value_type> & element)
+      {
+      element.emplace(std::move(front()));
+      drop_front();
+      }
+
+    template<typename ConsumerType>
+    auto do_consume(ConsumerType && consumer)
+      {
+      queue_detail::finish_after([&]{ drop_front(); }, [&]{ std::forward<ConsumerType>(consumer)(front()); });
+      }
+
+    decltype(auto) front() noexcept
+      {
+      return *(ptr() + to_buffer_index(m_head.load(std::memory_order_relaxed)));
+      }
+
+    auto drop_front()
+      {
+      auto const head = m_head.load(std::memory_order_relaxed);
+      queue_detail::destroy_element(m_allocator, ptr() + to_buffer_index(head));
+      m_head.store(head + 1, std::memory_order_release);
+
+      m_parking.wake_producer();
+      }
+
+    auto wait_for_space()
+      {
+      if(do_full())
+        {
+        m_parking.wait_for_space([&]{ return push_ready(); });
+        }
+      }
+
+    auto wait_for_elements()
+      {
+      if(do_empty())
+        {
+        m_parking.wait_for_elements([&]{ return pop_ready(); });
+        }
+      }
+
+    auto push_ready() noexcept
+      {
+      return closed() || !do_full();
+      }
+
+    auto pop_ready() noexcept
+      {
+      return !do_empty() || closed();
+      }
+
+    auto throw_if_closed() const
+      {
+      if(closed()) throw queue_closed{"Tried to push to a closed BoundedQueue"};
+      }
+
+    auto throw_if_drained()
+      {
+      if(do_empty()) throw queue_closed{"BoundedQueue is closed and drained"};
+      }
+
+    template<typename AtomicType>
+    static auto exchange(AtomicType & lhs, AtomicType & rhs) noexcept
+      {
+      lhs.store(rhs.exchange(lhs.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+
+    auto to_buffer_index(size_type const index) const noexcept
+      {
+      return m_mask ? index & m_mask : index % m_maximumSize;
+      }
+
+    auto ptr() noexcept
+      {
+      return reinterpret_cast<pointer>(m_data);
+      }
+
+    auto ptr() const noexcept
+      {
+      return reinterpret_cast<const_pointer>(m_data);
+      }
+
+    size_type m_maximumSize{};
+    size_type m_mask{};
+    __allocator m_allocator;
+    __storage * m_data{};
+    std::atomic<bool> m_closed{};
+
+    alignas(queue_layout::alignment<LayoutPolicy, __index>) __index m_head{};
+    size_type m_tailCache{};
+
+    alignas(queue_layout::alignment<LayoutPolicy, __index>) __index m_tail{};
+    size_type m_headCache{};
+
+    alignas(queue_layout::alignment<LayoutPolicy, __parking>) __parking m_parking{};
+  };
+
+template<typename ValueType, typename MutexType, typename ConditionType, typename LayoutPolicy, typename AllocatorType>
+struct BoundedQueue<ValueType, MutexType, ConditionType, queue_policy::mpmc, LayoutPolicy, queue_statistics::disabled, AllocatorType>
+  {
+  using value_type      = ValueType;
+  using reference       = value_type &;
+  using const_reference = value_type const &;
+  using pointer         = value_type *;
+  using const_pointer   = value_type const *;
+  using size_type       = std::size_t;
+  using allocator_type  = AllocatorType;
+
+  using __index = std::atomic<size_type>;
+  using __parking = queue_detail::parking<MutexType, ConditionType>;
+  using __clock = std::chrono::steady_clock;
+
+  static constexpr size_type __closed{size_type{1} << (std::numeric_limits<size_type>::digits - 1)};
+
+  struct __slot
+    {
+    __index sequence;
+    std::aligned_storage_t<sizeof(value_type), alignof(value_type)> storage;
+    };
+
+  using __allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<__slot>;
+  using __allocator_traits = std::allocator_traits<__allocator>;
+
+  BoundedQueue(size_type const size, allocator_type const & allocator = allocator_type{})
+    : m_maximumSize{size ? size : throw std::invalid_argument{"Tried to allocate BoundedQueue of size 0"}},
+      m_mask{queue_detail::index_mask(size)},
+      m_allocator{allocator},
+      m_slots{__allocator_traits::allocate(m_allocator, size)}
+    {
+    for(size_type index{}; index < m_maximumSize; ++index)
+      {
+      ::new (&m_slots[index]) __slot{{2 * index}, {}};
+      }
+    }
+
+  BoundedQueue(BoundedQueue const & other)
+    : BoundedQueue{other, __allocator_traits::select_on_container_copy_construction(other.m_allocator)}
+    {
+
+    }
+
+  BoundedQueue(BoundedQueue const & other, allocator_type const & allocator)
+    : BoundedQueue{other.m_maximumSize, allocator}
+    {
+    auto const last = other.m_enqueuePosition.load(std::memory_order_acquire);
+
+    for(auto position = other.m_dequeuePosition.load(std::memory_order_acquire); position != (last & ~__closed); ++position)
+      {
+      auto const & slot = other.m_slots[other.to_buffer_index(position)];
+      assert(slot.sequence.load(std::memory_order_acquire) == 2 * position + 1);
+
+      try_push(element(slot));
+      }
+
+    if(last & __closed)
+      {
+      close();
+      }
+    }
+
+  BoundedQueue(BoundedQueue && other)
+    : m_allocator{other.m_allocator}
+    {
+    swap(other);
+    }
+
+  /**
+   * Moves the elements one by one into storage from allocator.
+   */
+  BoundedQueue(BoundedQueue && other, allocator_type const & allocator)
+    : BoundedQueue{other.m_maximumSize, allocator}
+    {
+    auto const last = other.m_enqueuePosition.load(std::memory_order_acquire);
+
+    for(auto position = other.m_dequeuePosition.load(std::memory_order_acquire); position != (last & ~__closed); ++position)
+      {
+      auto & slot = other.m_slots[other.to_buffer_index(position)];
+      assert(slot.sequence.load(std::memory_order_acquire) == 2 * position + 1);
+
+      try_push(std::move(element(slot)));
+      }
+
+    if(last & __closed)
+      {
+      close();
+      }
+    }
+
+  ~BoundedQueue()
+    {
+    auto const last = m_enqueuePosition.load(std::memory_order_relaxed) & ~__closed;
+
+    for(auto position = m_dequeuePosition.load(std::memory_order_relaxed); position != last; ++position)
+      {
+      queue_detail::destroy_element(m_allocator, &element(m_slots[to_buffer_index(position)]));
+      }
+
+    if(m_slots)
+      {
+      __allocator_traits::deallocate(m_allocator, m_slots, m_maximumSize);
+      }
+    }
+
+  auto empty() const noexcept
+    {
+    return !size();
+    }
+
+  auto full() const noexcept
+    {
+    return size() == m_maximumSize;
+    }
+
+  size_type size() const noexcept
+    {
+    auto const dequeued = m_dequeuePosition.load(std::memory_order_acquire);
+    return std::min((m_enqueuePosition.load(std::memory_order_acquire) & ~__closed) - dequeued, m_maximumSize);
+    }
+
+  auto closed() const noexcept
+    {
+    return static_cast<bool>(m_enqueuePosition.load(std::memory_order_acquire) & __closed);
+    }
+
+  /**
+   * Wakes all waiting threads. Afterwards pushes fail, while consumers drain the remaining elements before the
+   * queue reports the end of the stream.
+   */
+  auto close()
+    {
+    m_enqueuePosition.fetch_or(__closed, std::memory_order_acq_rel);
+    m_parking.wake_all();
+    }
+
+  auto push(value_type const & elem)
+    {
+    do_emplace(claim_push_blocking(), elem);
+    }
+
+  auto push(value_type && elem)
+    {
+    do_emplace(claim_push_blocking(), std::move(elem));
+    }
+
+  value_type pop()
+    {
+    auto const claimed = claim_pop_blocking();
+    if(!claimed.slot)
+      {
+      throw queue_closed{"BoundedQueue is closed and drained"};
+      }
+
+    return do_pop(claimed);
+    }
+
+  template<typename... ArgumentTypes>
+  auto emplace(ArgumentTypes && ... arguments)
+    {
+    do_emplace(claim_push_blocking(), std::forward<ArgumentTypes>(arguments)...);
+    }
+
+  template<typename... ArgumentTypes>
+  auto try_emplace(ArgumentTypes && ... arguments)
+    {
+    auto const claimed = claim_push();
+    if(!claimed.slot)
+      {
+      return false;
+      }
+
+    do_emplace(claimed, std::forward<ArgumentTypes>(arguments)...);
+    return true;
+    }
+
+  /**
+   * Hands the front element to the consumer in place and removes it afterwards, even if the consumer throws.
+   * Returns false once the queue is closed and drained.
+   */
+  template<typename ConsumerType>
+  auto consume(ConsumerType && consumer)
+    {
+    auto const claimed = claim_pop_blocking();
+    if(!claimed.slot)
+      {
+      return false;
+      }
+
+    do_consume(claimed, std::forward<ConsumerType>(consumer));
+    return true;
+    }
+
+  template<typename ConsumerType>
+  auto try_consume(ConsumerType && consumer)
+    {
+    auto const claimed = claim_pop();
+    if(!claimed.slot)
+      {
+      return false;
+      }
+
+    do_consume(claimed, std::forward<ConsumerType>(consumer));
+    return true;
+    }
+
+  auto try_push(value_type const & elem)
+    {
+    return try_push_claimed(elem, claim_push());
+    }
+
+  auto try_push(value_type && elem)
+    {
+    return try_push_claimed(std::move(elem), claim_push());
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_push_for(value_type const & elem, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return try_emplace_for(timeout, elem);
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_push_for(value_type && elem, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return try_emplace_for(timeout, std::move(elem));
+    }
+
+  template<typename RepresentationType, typename Period, typename... ArgumentTypes>
+  auto try_emplace_for(std::chrono::duration<RepresentationType, Period> const & timeout, ArgumentTypes && ... arguments)
+    {
+    auto const claimed = claim_push_until(__clock::now() + timeout);
+    if(!claimed.slot)
+      {
+      return false;
+      }
+
+    do_emplace(claimed, std::forward<ArgumentTypes>(arguments)...);
+    return true;
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_pop_for(value_type & target, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return try_pop_claimed(target, claim_pop_until(__clock::now() + timeout));
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_pop_for(std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return take(claim_pop_until(__clock::now() + timeout));
+    }
+
+  auto try_pop(value_type & target)
+    {
+    return try_pop_claimed(target, claim_pop());
+    }
+
+  auto try_pop()
+    {
+    return take(claim_pop());
+    }
+
+  auto get_allocator() const
+    {
+    return allocator_type{m_allocator};
+    }
+
+  auto swap(BoundedQueue & other)
+    {
+    do_swap(other, typename __allocator_traits::propagate_on_container_swap{});
+    }
+
+  decltype(auto) operator=(BoundedQueue const & other)
+    {
+    if(this != &other)
+      {
+      BoundedQueue temporary{other, queue_detail::copy_assignment_allocator(m_allocator, other.m_allocator)};
+      do_swap(temporary, typename __allocator_traits::propagate_on_container_copy_assignment{});
+      }
+
+    return *this;
+    }
+
+  decltype(auto) operator=(BoundedQueue && other)
+    {
+    if(this != &other)
+      {
+      move_assign(other, typename __allocator_traits::propagate_on_container_move_assignment{});
+      }
+
+    return *this;
+    }
+
+  private:
+    template<typename Propagate>
+    auto do_swap(BoundedQueue & other, Propagate const propagate)
+      {
+      std::swap(m_maximumSize, other.m_maximumSize);
+      std::swap(m_mask, other.m_mask);
+      queue_detail::swap_allocators(m_allocator, other.m_allocator, propagate);
+      std::swap(m_slots, other.m_slots);
+      exchange(m_enqueuePosition, other.m_enqueuePosition);
+      exchange(m_dequeuePosition, other.m_dequeuePosition);
+      }
+
+    auto move_assign(BoundedQueue & other, std::true_type)
+      {
+      do_swap(other, std::true_type{});
+      }
+
+    auto move_assign(BoundedQueue & other, std::false_type)
+      {
+      if(m_allocator == other.m_allocator)
+        {
+        do_swap(other, std::false_type{});
+        return;
+        }
+
+      BoundedQueue temporary{std::move(other), get_allocator()};
+      do_swap(temporary, std::false_type{});
+      }
+
+    struct __claim
+      {
+      __slot * slot;
+      size_type position;
+      };
+
+    /*
+     * A slot is free for writing position p when its sequence equals 2p, and holds the element of position p when
+     * its sequence equals 2p + 1. Popping advances the sequence to 2(p + m_maximumSize), the position the slot sees
+     * on the next lap. Doubling keeps both states apart even for a queue of size 1. close() sets the top bit of
+     * the enqueue cursor, which makes every later compare-exchange of a producer fail.
+     */
+    auto claim_push() noexcept
+      {
+      return claim(m_enqueuePosition, 0);
+      }
+
+    auto claim_pop() noexcept
+      {
+      return claim(m_dequeuePosition, 1);
+      }
+
+    auto claim(__index & cursor, size_type const lag) noexcept
+      {
+      auto position = cursor.load(std::memory_order_relaxed);
+
+      for(;;)
+        {
+        if(position & __closed)
+          {
+          return __claim{nullptr, position};
+          }
+
+        auto & slot = m_slots[to_buffer_index(position)];
+        auto const sequence = slot.sequence.load(std::memory_order_acquire);
+        auto const difference = static_cast<std::ptrdiff_t>(sequence - (2 * position + lag));
+
+        if(!difference)
+          {
+          if(cursor.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+            return __claim{&slot, position};
+            }
+          }
+        else if(difference < 0)
+          {
+          return __claim{nullptr, position};
+          }
+        else
+          {
+          position = cursor.load(std::memory_order_relaxed);
+          }
+        }
+      }
+
+    auto can_push() const noexcept
+      {
+      return is_ready(m_enqueuePosition, 0);
+      }
+
+    auto can_pop() const noexcept
+      {
+      return is_ready(m_dequeuePosition, 1);
+      }
+
+    auto push_ready() const noexcept
+      {
+      return can_push() || closed();
+      }
+
+    auto pop_ready() const noexcept
+      {
+      return can_pop() || drained();
+      }
+
+    auto drained() const noexcept
+      {
+      auto const enqueued = m_enqueuePosition.load(std::memory_order_acquire);
+      return (enqueued & __closed) && m_dequeuePosition.load(std::memory_order_acquire) == (enqueued & ~__closed);
+      }
+
+    auto is_ready(__index const & cursor, size_type const lag) const noexcept
+      {
+      auto const position = cursor.load(std::memory_order_relaxed) & ~__closed;
+      auto const sequence = m_slots[to_buffer_index(position)].sequence.load(std::memory_order_acquire);
+      return static_cast<std::ptrdiff_t>(sequence - (2 * position + lag)) >= 0;
+      }
+
+    auto claim_push_blocking()
+      {
+      auto const claimed = claim_blocking(&BoundedQueue::claim_push, [&]{ return closed(); }, [&]{
+        m_parking.wait_for_space([&]{ return push_ready(); });
+      });
+
+      if(!claimed.slot)
+        {
+        throw queue_closed{"Tried to push to a closed BoundedQueue"};
+        }
+
+      return claimed;
+      }
+
+    auto claim_pop_blocking()
+      {
+      return claim_blocking(&BoundedQueue::claim_pop, [&]{ return drained(); }, [&]{
+        m_parking.wait_for_elements([&]{ return pop_ready(); });
+      });
+      }
+
+    template<typename FinishedPredicate, typename WaitOperation>
+    auto claim_blocking(__claim (BoundedQueue::*claimer)(), FinishedPredicate && finished, WaitOperation && wait)
+      {
+      auto claimed = (this->*claimer)();
+
+      while(!claimed.slot && !finished())
+        {
+        wait();
+        claimed = (this->*claimer)();
+        }
+
+      return claimed;
+      }
+
+    auto claim_push_until(__clock::time_point const deadline)
+      {
+      return claim_until(&BoundedQueue::claim_push, [&]{ return closed(); }, deadline, [&](auto remaining){
+        m_parking.wait_for_space([&]{ return push_ready(); }, remaining);
+      });
+      }
+
+    auto claim_pop_until(__clock::time_point const deadline)
+      {
+      return claim_until(&BoundedQueue::claim_pop, [&]{ return drained(); }, deadline, [&](auto remaining){
+        m_parking.wait_for_elements([&]{ return pop_ready(); }, remaining);
+      });
+      }
+
+    template<typename FinishedPredicate, typename WaitOperation>
+    auto claim_until(__claim (BoundedQueue::*claimer)(), FinishedPredicate && finished, __clock::time_point const deadline,
+                     WaitOperation && wait)
+      {
+      auto claimed = (this->*claimer)();
+
+      while(!claimed.slot && !finished())
+        {
+        auto const now = __clock::now();
+
+        if(now >= deadline)
+          {
+          break;
+          }
+
+        wait(deadline - now);
+        claimed = (this->*claimer)();
+        }
+
+      return claimed;
+      }
+
+    template<typename ElementType>
+    auto try_push_claimed(ElementType && element, __claim const claimed)
+      {
+      if(!claimed.slot)
+        {
+        return false;
+        }
+
+      do_emplace(claimed, std::forward<ElementType>(element));
+      return true;
+      }
+
+    auto try_pop_claimed(value_type & target, __claim const claimed)
+      {
+      if(!claimed.slot)
+        {
+        return false;
+        }
+
+      target = do_pop(claimed);
+      return true;
+      }
+
+    template<typename... ArgumentTypes>
+    auto do_emplace(__claim const claimed, ArgumentTypes && ... arguments)
+      {
+      queue_detail::construct_element(m_allocator, &element(*claimed.slot), std::forward<ArgumentTypes>(arguments)...);
+      claimed.slot->sequence.store(2 * claimed.position + 1, std::memory_order_release);
+
+      m_parking.wake_consumer();
+      }
+
+    value_type do_pop(__claim const claimed)
+      {
+      auto temporary = std::move(element(*claimed.slot));
+      release(claimed);
+
+      return temporary;
+      }
+
+    auto take(__claim const claimed)
+      {
+      boost::optional<value_type> target{};
+
+      if(claimed.slot)
+        {
+        target.emplace(std::move(element(*claimed.slot)));
+        release(claimed);
+        }
+
+      return target;
+      }
+
+    template<typename ConsumerType>
+    auto do_consume(__claim const claimed, ConsumerType && consumer)
+      {
+      queue_detail::finish_after([&]{ release(claimed); }, [&]{ std::forward<ConsumerType>(consumer)(element(*claimed.slot)); });
+      }
+
+    auto release(__claim const claimed)
+      {
+      queue_detail::destroy_element(m_allocator, &element(*claimed.slot));
+      claimed.slot->sequence.store(2 * (claimed.position + m_maximumSize), std::memory_order_release);
+
+      m_parking.wake_producer();
+      }
+
+    static auto exchange(__index & lhs, __index & rhs) noexcept
+      {
+      lhs.store(rhs.exchange(lhs.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+
+    static decltype(auto) element(__slot & slot) noexcept
+      {
+      return *reinterpret_cast<pointer>(&slot.storage);
+      }
+
+    static decltype(auto) element(__slot const & slot) noexcept
+      {
+      return *reinterpret_cast<const_pointer>(&slot.storage);
+      }
+
+    auto to_buffer_index(size_type const position) const noexcept
+      {
+      return m_mask ? position & m_mask : position % m_maximumSize;
+      }
+
+    size_type m_maximumSize{};
+    size_type m_mask{};
+    __allocator m_allocator;
+    __slot * m_slots{};
+
+    alignas(queue_layout::alignment<LayoutPolicy, __index>) __index m_enqueuePosition{};
+    alignas(queue_layout::alignment<LayoutPolicy, __index>) __index m_dequeuePosition{};
+    alignas(queue_layout::alignment<LayoutPolicy, __parking>) __parking m_parking{};
+  };
+
+#endif
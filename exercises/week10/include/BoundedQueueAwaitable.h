@@ -0,0 +1,96 @@
+#ifndef __FMO__BOUNDED_QUEUE_AWAITABLE
+#define __FMO__BOUNDED_QUEUE_AWAITABLE
+
+#include "BoundedQueue.h"
+
+/*
+ * Coroutine adapters for async_pop() and async_push(). The exercises are built as C++14, so this header only
+ * provides them when it is compiled with coroutine support.
+ */
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <utility>
+
+namespace queue_coroutine
+  {
+  template<typename QueueType, typename ExecutorType>
+  struct pop_awaitable
+    {
+    using value_type = typename QueueType::value_type;
+
+    bool await_ready() const noexcept
+      {
+      return false;
+      }
+
+    void await_suspend(std::coroutine_handle<> coroutine)
+      {
+      queue.async_pop(executor, [this, coroutine](boost::optional<value_type> element){
+        result = std::move(element);
+        coroutine.resume();
+      });
+      }
+
+    boost::optional<value_type> await_resume()
+      {
+      return std::move(result);
+      }
+
+    QueueType & queue;
+    ExecutorType & executor;
+    boost::optional<value_type> result{};
+    };
+
+  template<typename QueueType, typename ExecutorType>
+  struct push_awaitable
+    {
+    using value_type = typename QueueType::value_type;
+
+    bool await_ready() const noexcept
+      {
+      return false;
+      }
+
+    void await_suspend(std::coroutine_handle<> coroutine)
+      {
+      queue.async_push(std::move(element), executor, [this, coroutine](bool success){
+        pushed = success;
+        coroutine.resume();
+      });
+      }
+
+    bool await_resume() const noexcept
+      {
+      return pushed;
+      }
+
+    QueueType & queue;
+    ExecutorType & executor;
+    value_type element;
+    bool pushed{};
+    };
+
+  /**
+   * co_await async_pop(queue, executor) suspends the coroutine until an element is available and resumes it as a
+   * task of the executor. The result is empty once the queue is closed and drained.
+   */
+  template<typename QueueType, typename ExecutorType>
+  auto async_pop(QueueType & queue, ExecutorType & executor)
+    {
+    return pop_awaitable<QueueType, ExecutorType>{queue, executor};
+    }
+
+  /**
+   * co_await async_push(queue, element, executor) yields false if the queue was closed before the element fit.
+   */
+  template<typename QueueType, typename ExecutorType>
+  auto async_push(QueueType & queue, typename QueueType::value_type element, ExecutorType & executor)
+    {
+    return push_awaitable<QueueType, ExecutorType>{queue, executor, std::move(element)};
+    }
+  }
+
+#endif
+
+#endif
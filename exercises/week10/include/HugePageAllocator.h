@@ -0,0 +1,169 @@
+#ifndef __FMO__HUGE_PAGE_ALLOCATOR
+#define __FMO__HUGE_PAGE_ALLOCATOR
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * An allocator for the storage of large rings, to be used as AllocatorType of BoundedQueue or BoundedBuffer.
+ *
+ * Allocations of at least one huge page are mapped directly, aligned to the huge page size, and advised to be
+ * backed by transparent huge pages. Their pages are preferably placed on the NUMA node of the allocating thread,
+ * so construct the queue on the node that uses it. Both are hints, the kernel may still fall back to small or
+ * remote pages. Smaller allocations, and all allocations on other platforms, come from std::allocator.
+ */
+template<typename ValueType>
+struct HugePageAllocator
+  {
+  using value_type = ValueType;
+  using is_always_equal = std::true_type;
+
+  static constexpr std::size_t huge_page_size{std::size_t{2} << 20};
+
+  HugePageAllocator() = default;
+
+  template<typename OtherType>
+  HugePageAllocator(HugePageAllocator<OtherType> const &) noexcept
+    {
+
+    }
+
+  value_type * allocate(std::size_t const count)
+    {
+    if(count > std::numeric_limits<std::size_t>::max() / sizeof(value_type))
+      {
+      throw std::bad_alloc{};
+      }
+
+    if(!mapped(count))
+      {
+      return std::allocator<value_type>{}.allocate(count);
+      }
+
+    return static_cast<value_type *>(map(count * sizeof(value_type)));
+    }
+
+  void deallocate(value_type * const pointer, std::size_t const count) noexcept
+    {
+    if(!mapped(count))
+      {
+      std::allocator<value_type>{}.deallocate(pointer, count);
+      return;
+      }
+
+    unmap(pointer, count * sizeof(value_type));
+    }
+
+  private:
+    static auto round_up(std::uintptr_t const value) noexcept
+      {
+      return (value + huge_page_size - 1) & ~std::uintptr_t{huge_page_size - 1};
+      }
+
+#if defined(__linux__)
+    static auto mapped(std::size_t const count) noexcept
+      {
+      return count * sizeof(value_type) >= huge_page_size;
+      }
+
+    /*
+     * Maps one huge page more than needed and returns the unaligned head and tail, so the range starts on a huge
+     * page boundary.
+     */
+    static void * map(std::size_t const size)
+      {
+      auto const length = round_up(size);
+      auto const raw = ::mmap(nullptr, length + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+      if(raw == MAP_FAILED)
+        {
+        throw std::bad_alloc{};
+        }
+
+      auto const address = reinterpret_cast<std::uintptr_t>(raw);
+      auto const aligned = round_up(address);
+
+      if(aligned != address)
+        {
+        ::munmap(raw, aligned - address);
+        }
+
+      if(auto const tail = address + huge_page_size - aligned)
+        {
+        ::munmap(reinterpret_cast<void *>(aligned + length), tail);
+        }
+
+      auto const memory = reinterpret_cast<void *>(aligned);
+      ::madvise(memory, length, MADV_HUGEPAGE);
+      prefer_local_node(memory, length);
+
+      return memory;
+      }
+
+    static void unmap(void * const memory, std::size_t const size) noexcept
+      {
+      ::munmap(memory, round_up(size));
+      }
+
+    /*
+     * The pages are not touched yet, so the policy decides where they will be faulted in. Without NUMA support
+     * mbind fails and the default first-touch placement remains. mbind reads one bit less than maxnode.
+     */
+    static void prefer_local_node(void * const memory, std::size_t const length) noexcept
+      {
+      constexpr std::size_t maximumNodes{1024};
+      constexpr std::size_t bits = std::numeric_limits<unsigned long>::digits;
+      unsigned long nodes[maximumNodes / bits]{};
+      unsigned cpu{};
+      unsigned node{};
+
+      if(::syscall(SYS_getcpu, &cpu, &node, nullptr) || node >= maximumNodes)
+        {
+        return;
+        }
+
+      nodes[node / bits] |= 1ul << (node % bits);
+      ::syscall(SYS_mbind, memory, length, MPOL_PREFERRED, nodes, maximumNodes + 1, 0u);
+      }
+#else
+    static auto mapped(std::size_t) noexcept
+      {
+      return false;
+      }
+
+    static void * map(std::size_t)
+      {
+      throw std::bad_alloc{};
+      }
+
+    static void unmap(void *, std::size_t) noexcept
+      {
+
+      }
+#endif
+  };
+
+template<typename ValueType, typename OtherType>
+bool operator==(HugePageAllocator<ValueType> const &, HugePageAllocator<OtherType> const &) noexcept
+  {
+  return true;
+  }
+
+template<typename ValueType, typename OtherType>
+bool operator!=(HugePageAllocator<ValueType> const &, HugePageAllocator<OtherType> const &) noexcept
+  {
+  return false;
+  }
+
+#endif
@@ -0,0 +1,451 @@
+#ifndef __FMO__PRIORITY_BOUNDED_QUEUE
+#define __FMO__PRIORITY_BOUNDED_QUEUE
+
+#include "BoundedQueue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A bounded, blocking queue that pops the element with the highest priority first.
+ *
+ * Like std::priority_queue, an element a has lower priority than b if Compare(a, b) holds, so the default pops the
+ * largest element. Elements of equal priority leave in the order they were pushed. Fixed priority lanes are a
+ * comparator on the lane of an element.
+ *
+ * The elements form a binary heap in raw storage. Elements are never default constructed or assigned, a sift moves
+ * them by move construction into the current hole, so push and pop take O(log n) moves and comparisons.
+ *
+ * A sift cannot undo half of its moves, so ValueType must be nothrow move constructible. A throwing Compare leaves
+ * the queue intact: a push then does not happen, a pop loses only the popped element and may leave the heap out of
+ * order.
+ */
+template<typename ValueType,
+         typename Compare = std::less<ValueType>,
+         typename MutexType = std::mutex,
+         typename ConditionType = std::condition_variable>
+struct PriorityBoundedQueue
+  {
+  using value_type      = ValueType;
+  using value_compare   = Compare;
+  using reference       = value_type &;
+  using const_reference = value_type const &;
+  using size_type       = std::size_t;
+
+  using __mutex = MutexType;
+  using __condition = ConditionType;
+  using __guard = std::lock_guard<__mutex>;
+  using __ulock = std::unique_lock<__mutex>;
+
+  static_assert(std::is_nothrow_move_constructible<value_type>::value,
+                "PriorityBoundedQueue requires a nothrow move constructible ValueType");
+
+  struct __slot
+    {
+    size_type sequence;
+    std::aligned_storage_t<sizeof(value_type), alignof(value_type)> storage;
+    };
+
+  explicit PriorityBoundedQueue(size_type const size, value_compare const & compare = value_compare{})
+    : m_maximumSize{size ? size : throw std::invalid_argument{"Tried to allocate PriorityBoundedQueue of size 0"}},
+      m_slots{new __slot[size]},
+      m_compare{compare}
+    {
+
+    }
+
+  PriorityBoundedQueue(PriorityBoundedQueue const & other)
+    : PriorityBoundedQueue{other.m_maximumSize, other.m_compare}
+    {
+    __guard guard{other.m_mutex};
+
+    for(; m_size < other.m_size; ++m_size)
+      {
+      new (&m_slots[m_size].storage) value_type(element(other.m_slots[m_size]));
+      m_slots[m_size].sequence = other.m_slots[m_size].sequence;
+      }
+
+    m_sequence = other.m_sequence;
+    m_closed = other.m_closed;
+    }
+
+  PriorityBoundedQueue(PriorityBoundedQueue && other)
+    : m_compare{other.m_compare}
+    {
+    swap(other);
+    }
+
+  ~PriorityBoundedQueue()
+    {
+    for(size_type index{}; index < m_size; ++index)
+      {
+      element(m_slots[index]).~value_type();
+      }
+
+    delete[](m_slots);
+    }
+
+  auto empty() const
+    {
+    __guard guard{m_mutex};
+    return !m_size;
+    }
+
+  auto full() const
+    {
+    __guard guard{m_mutex};
+    return m_size == m_maximumSize;
+    }
+
+  auto size() const
+    {
+    __guard guard{m_mutex};
+    return m_size;
+    }
+
+  auto closed() const
+    {
+    __guard guard{m_mutex};
+    return m_closed;
+    }
+
+  auto close()
+    {
+    __guard guard{m_mutex};
+    m_closed = true;
+
+    m_hasSpace.notify_all();
+    m_hasElements.notify_all();
+    }
+
+  auto push(value_type const & elem)
+    {
+    emplace(elem);
+    }
+
+  auto push(value_type && elem)
+    {
+    emplace(std::move(elem));
+    }
+
+  template<typename... ArgumentTypes>
+  auto emplace(ArgumentTypes && ... arguments)
+    {
+    __ulock ulock{m_mutex};
+    wait(ulock, m_hasSpace, m_producersWaiting, [&]{ return push_ready(); });
+
+    if(m_closed)
+      {
+      throw queue_closed{"Tried to push to a closed PriorityBoundedQueue"};
+      }
+
+    do_push(std::forward<ArgumentTypes>(arguments)...);
+    }
+
+  value_type pop()
+    {
+    __ulock ulock{m_mutex};
+    wait(ulock, m_hasElements, m_consumersWaiting, [&]{ return pop_ready(); });
+
+    if(!m_size)
+      {
+      throw queue_closed{"PriorityBoundedQueue is closed and drained"};
+      }
+
+    return do_pop();
+    }
+
+  auto try_push(value_type const & elem)
+    {
+    return try_emplace(elem);
+    }
+
+  auto try_push(value_type && elem)
+    {
+    return try_emplace(std::move(elem));
+    }
+
+  template<typename... ArgumentTypes>
+  auto try_emplace(ArgumentTypes && ... arguments)
+    {
+    __guard guard{m_mutex};
+    if(m_closed || m_size == m_maximumSize)
+      {
+      return false;
+      }
+
+    do_push(std::forward<ArgumentTypes>(arguments)...);
+    return true;
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_push_for(value_type const & elem, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    __ulock ulock{m_mutex};
+    if(!wait_for(ulock, m_hasSpace, m_producersWaiting, timeout, [&]{ return push_ready(); }) || m_closed)
+      {
+      return false;
+      }
+
+    do_push(elem);
+    return true;
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_push_for(value_type && elem, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    __ulock ulock{m_mutex};
+    if(!wait_for(ulock, m_hasSpace, m_producersWaiting, timeout, [&]{ return push_ready(); }) || m_closed)
+      {
+      return false;
+      }
+
+    do_push(std::move(elem));
+    return true;
+    }
+
+  auto try_pop(value_type & target)
+    {
+    __guard guard{m_mutex};
+    if(!m_size)
+      {
+      return false;
+      }
+
+    target = do_pop();
+    return true;
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_pop_for(value_type & target, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    __ulock ulock{m_mutex};
+    if(!wait_for(ulock, m_hasElements, m_consumersWaiting, timeout, [&]{ return pop_ready(); }) || !m_size)
+      {
+      return false;
+      }
+
+    target = do_pop();
+    return true;
+    }
+
+  auto swap(PriorityBoundedQueue & other)
+    {
+    __ulock theirs{other.m_mutex, std::defer_lock};
+    __ulock ours{m_mutex, std::defer_lock};
+    std::lock(ours, theirs);
+
+    std::swap(m_maximumSize, other.m_maximumSize);
+    std::swap(m_slots, other.m_slots);
+    std::swap(m_size, other.m_size);
+    std::swap(m_sequence, other.m_sequence);
+    std::swap(m_closed, other.m_closed);
+    std::swap(m_compare, other.m_compare);
+    }
+
+  decltype(auto) operator=(PriorityBoundedQueue const & other)
+    {
+    if(this != &other)
+      {
+      PriorityBoundedQueue temporary{other};
+      swap(temporary);
+      }
+
+    return *this;
+    }
+
+  decltype(auto) operator=(PriorityBoundedQueue && other)
+    {
+    if(this != &other)
+      {
+      swap(other);
+      }
+
+    return *this;
+    }
+
+  private:
+    auto push_ready() const noexcept
+      {
+      return m_closed || m_size < m_maximumSize;
+      }
+
+    auto pop_ready() const noexcept
+      {
+      return m_closed || m_size;
+      }
+
+    template<typename PredicateType>
+    static auto wait(__ulock & ulock, __condition & condition, size_type & waiting, PredicateType && ready)
+      {
+      ++waiting;
+      auto leave = [&]{ --waiting; };
+      queue_detail::scope_exit<decltype(leave)> guard{leave};
+
+      condition.wait(ulock, std::forward<PredicateType>(ready));
+      }
+
+    template<typename RepresentationType, typename Period, typename PredicateType>
+    static auto wait_for(__ulock & ulock, __condition & condition, size_type & waiting,
+                         std::chrono::duration<RepresentationType, Period> const & timeout, PredicateType && ready)
+      {
+      ++waiting;
+      auto leave = [&]{ --waiting; };
+      queue_detail::scope_exit<decltype(leave)> guard{leave};
+
+      return condition.wait_for(ulock, timeout, std::forward<PredicateType>(ready));
+      }
+
+    /*
+     * a has lower priority than b, ties are broken by the push order.
+     */
+    auto lower(__slot const & a, __slot const & b) const
+      {
+      return m_compare(element(a), element(b)) || (!m_compare(element(b), element(a)) && a.sequence > b.sequence);
+      }
+
+    template<typename... ArgumentTypes>
+    auto do_push(ArgumentTypes && ... arguments)
+      {
+      auto & last = m_slots[m_size];
+      new (&last.storage) value_type(std::forward<ArgumentTypes>(arguments)...);
+      last.sequence = m_sequence++;
+
+      try
+        {
+        sift_up(m_size);
+        }
+      catch(...)
+        {
+        element(last).~value_type();
+        throw;
+        }
+
+      ++m_size;
+
+      if(m_consumersWaiting)
+        {
+        m_hasElements.notify_one();
+        }
+      }
+
+    value_type do_pop()
+      {
+      auto temporary = std::move(element(m_slots[0]));
+      element(m_slots[0]).~value_type();
+
+      --m_size;
+
+      /*
+       * The lock is held until the sift is done, so the producer can be notified before a comparison may throw.
+       */
+      if(m_producersWaiting)
+        {
+        m_hasSpace.notify_one();
+        }
+
+      if(m_size)
+        {
+        sift_down();
+        }
+
+      return temporary;
+      }
+
+    /*
+     * The new element waits in its own slot while its parents move down into the hole above it, it is moved
+     * only once into the final hole. All comparisons happen before the first move.
+     */
+    auto sift_up(size_type const index)
+      {
+      auto hole = index;
+
+      while(hole && lower(m_slots[(hole - 1) / 2], m_slots[index]))
+        {
+        hole = (hole - 1) / 2;
+        }
+
+      if(hole == index)
+        {
+        return;
+        }
+
+      auto rising = std::move(element(m_slots[index]));
+      auto const sequence = m_slots[index].sequence;
+      element(m_slots[index]).~value_type();
+
+      for(auto position = index; position != hole; position = (position - 1) / 2)
+        {
+        relocate(m_slots[(position - 1) / 2], m_slots[position]);
+        }
+
+      new (&m_slots[hole].storage) value_type(std::move(rising));
+      m_slots[hole].sequence = sequence;
+      }
+
+    /*
+     * The root is empty. The last element sinks from the root until no child has a higher priority, every
+     * child on the way moves up into the hole. If a comparison throws, the last element fills the current hole.
+     */
+    auto sift_down()
+      {
+      auto & last = m_slots[m_size];
+      size_type hole{};
+
+      queue_detail::finish_after([&]{ relocate(last, m_slots[hole]); }, [&]{
+        for(auto child = size_type{1}; child < m_size; child = 2 * hole + 1)
+          {
+          if(child + 1 < m_size && lower(m_slots[child], m_slots[child + 1]))
+            {
+            ++child;
+            }
+
+          if(!lower(last, m_slots[child]))
+            {
+            break;
+            }
+
+          relocate(m_slots[child], m_slots[hole]);
+          hole = child;
+          }
+      });
+      }
+
+    static auto relocate(__slot & source, __slot & target) noexcept
+      {
+      new (&target.storage) value_type(std::move(element(source)));
+      target.sequence = source.sequence;
+      element(source).~value_type();
+      }
+
+    static decltype(auto) element(__slot & slot) noexcept
+      {
+      return *reinterpret_cast<value_type *>(&slot.storage);
+      }
+
+    static decltype(auto) element(__slot const & slot) noexcept
+      {
+      return *reinterpret_cast<value_type const *>(&slot.storage);
+      }
+
+    size_type m_maximumSize{};
+    __slot * m_slots{};
+    size_type m_size{};
+    size_type m_sequence{};
+    bool m_closed{};
+    value_compare m_compare;
+
+    __mutex mutable m_mutex{};
+    __condition m_hasSpace{};
+    __condition m_hasElements{};
+    size_type m_producersWaiting{};
+    size_type m_consumersWaiting{};
+  };
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef __FMO__QUEUE_SELECTOR
+#define __FMO__QUEUE_SELECTOR
+
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Waits on several locked BoundedQueues at once.
+ *
+ * Every watched queue reports through its observer when it starts or stops having something for a consumer, so
+ * the selector keeps one ready bit per queue and select() neither polls nor takes any queue's mutex. It returns the
+ * lowest ready index, so queues watched first take priority.
+ *
+ * A ready bit is a hint. Another consumer may empty the queue between select() and the pop, so use the try_
+ * operations on the selected queue and select again if they fail. A closed queue stays ready, so its consumers see
+ * the end of the stream. The selector has to be destroyed before the queues it watches. A queue has only one
+ * observer, so it can be watched by only one selector at a time, watch() throws if another one already does.
+ */
+struct queue_selector
+  {
+  using size_type = std::size_t;
+  using __mask = std::uint64_t;
+  using __guard = std::lock_guard<std::mutex>;
+  using __ulock = std::unique_lock<std::mutex>;
+
+  queue_selector() = default;
+  queue_selector(queue_selector const &) = delete;
+  queue_selector & operator=(queue_selector const &) = delete;
+
+  ~queue_selector()
+    {
+    for(auto & unwatch : m_unwatch)
+      {
+      unwatch();
+      }
+    }
+
+  template<typename QueueType>
+  auto watch(QueueType & queue)
+    {
+    auto const index = m_unwatch.size();
+
+    if(index == std::numeric_limits<__mask>::digits)
+      {
+      throw std::length_error{"Tried to watch too many queues with one queue_selector"};
+      }
+
+    m_unwatch.reserve(index + 1);
+    queue.observe([this, index](bool const ready){ update(index, ready); });
+    m_unwatch.push_back([&queue]{ queue.observe({}); });
+
+    return index;
+    }
+
+  /*
+   * Queues clear their bits without the selector mutex, so the mask is only read once, by the predicate that
+   * found it non-zero.
+   */
+  auto select()
+    {
+    __ulock ulock{m_mutex};
+    auto seen = __mask{};
+    ++m_waiting;
+    m_condition.wait(ulock, [&]{ return (seen = m_ready.load(std::memory_order_acquire)) != 0; });
+    --m_waiting;
+
+    return lowest(seen);
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto select_for(std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    __ulock ulock{m_mutex};
+    auto seen = __mask{};
+    ++m_waiting;
+    auto const ready = m_condition.wait_for(ulock, timeout, [&]{ return (seen = m_ready.load(std::memory_order_acquire)) != 0; });
+    --m_waiting;
+
+    return ready ? boost::make_optional(lowest(seen)) : boost::none;
+    }
+
+  private:
+    /*
+     * Called by the queues under their own lock. The selector mutex is only taken when a queue becomes ready,
+     * and the condition is only notified when somebody selects.
+     */
+    auto update(size_type const index, bool const ready)
+      {
+      auto const bit = __mask{1} << index;
+
+      if(!ready)
+        {
+        m_ready.fetch_and(~bit, std::memory_order_release);
+        return;
+        }
+
+      m_ready.fetch_or(bit, std::memory_order_release);
+
+      __guard guard{m_mutex};
+      if(m_waiting)
+        {
+        m_condition.notify_all();
+        }
+      }
+
+    static size_type lowest(__mask const ready) noexcept
+      {
+      assert(ready);
+      auto index = size_type{};
+
+      while(!(ready & (__mask{1} << index)))
+        {
+        ++index;
+        }
+
+      return index;
+      }
+
+    std::atomic<__mask> m_ready{};
+    std::mutex m_mutex{};
+    std::condition_variable m_condition{};
+    size_type m_waiting{};
+    std::vector<std::function<void()>> m_unwatch{};
+  };
+
+#endif
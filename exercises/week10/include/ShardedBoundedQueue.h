@@ -0,0 +1,445 @@
+#ifndef __FMO__SHARDED_BOUNDED_QUEUE
+#define __FMO__SHARDED_BOUNDED_QUEUE
+
+#include "BoundedQueue.h"
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace queue_detail
+  {
+  /*
+   * A small number per thread, handed out in the order in which threads first ask for it.
+   */
+  inline std::size_t thread_ticket() noexcept
+    {
+    static std::atomic<std::size_t> next{};
+    static thread_local auto const ticket = next.fetch_add(1, std::memory_order_relaxed);
+    return ticket;
+    }
+
+  /*
+   * The ConditionType of the shards. Nobody blocks on a shard, the sharded queue parks its waiters itself, so
+   * notifying a shard does nothing. Should a shard ever have to wait, it yields until the predicate holds.
+   */
+  struct unparked
+    {
+    template<typename LockType, typename PredicateType>
+    void wait(LockType & lock, PredicateType ready)
+      {
+      while(!ready())
+        {
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+        }
+      }
+
+    template<typename LockType, typename RepresentationType, typename Period, typename PredicateType>
+    bool wait_for(LockType & lock, std::chrono::duration<RepresentationType, Period> const & timeout, PredicateType ready)
+      {
+      auto const deadline = std::chrono::steady_clock::now() + timeout;
+
+      while(!ready())
+        {
+        if(std::chrono::steady_clock::now() >= deadline)
+          {
+          return false;
+          }
+
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+        }
+
+      return true;
+      }
+
+    void notify_one() noexcept
+      {
+
+      }
+
+    void notify_all() noexcept
+      {
+
+      }
+    };
+
+  /*
+   * The lock-free shards wake their waiters through a parking. Without waiters there is nothing to publish, so
+   * this parking has neither fences nor a mutex, and a push or pop into a shard costs no more than the slot itself.
+   */
+  template<typename MutexType>
+  struct parking<MutexType, unparked>
+    {
+    template<typename PredicateType>
+    auto wait_for_space(PredicateType && ready)
+      {
+      yield_until(ready);
+      }
+
+    template<typename PredicateType, typename RepresentationType, typename Period>
+    auto wait_for_space(PredicateType && ready, std::chrono::duration<RepresentationType, Period> const & timeout)
+      {
+      return yield_until(ready, std::chrono::steady_clock::now() + timeout);
+      }
+
+    template<typename PredicateType>
+    auto wait_for_elements(PredicateType && ready)
+      {
+      yield_until(ready);
+      }
+
+    template<typename PredicateType, typename RepresentationType, typename Period>
+    auto wait_for_elements(PredicateType && ready, std::chrono::duration<RepresentationType, Period> const & timeout)
+      {
+      return yield_until(ready, std::chrono::steady_clock::now() + timeout);
+      }
+
+    auto wake_producer() noexcept
+      {
+
+      }
+
+    auto wake_consumer() noexcept
+      {
+
+      }
+
+    auto wake_all() noexcept
+      {
+
+      }
+
+    private:
+      template<typename PredicateType>
+      static auto yield_until(PredicateType & ready)
+        {
+        while(!ready())
+          {
+          std::this_thread::yield();
+          }
+        }
+
+      template<typename PredicateType>
+      static auto yield_until(PredicateType & ready, std::chrono::steady_clock::time_point const deadline)
+        {
+        while(!ready())
+          {
+          if(std::chrono::steady_clock::now() >= deadline)
+            {
+            return false;
+            }
+
+          std::this_thread::yield();
+          }
+
+        return true;
+        }
+    };
+  }
+
+/**
+ * A bounded queue made of one BoundedQueue shard per core, for workloads that do not need a global FIFO order.
+ *
+ * Every thread has a local shard, chosen by the order in which threads first use a sharded queue. Producers push
+ * into their local shard and only move on to the other shards when it is full, consumers take from their local
+ * shard first and fall back to the others when it is empty. As long as every thread finds work in its own shard,
+ * threads do not share any cache line. Elements keep their order within a shard only.
+ *
+ * Blocking operations sleep on a parking shared by all shards, which is only touched when somebody waits. The
+ * shards themselves never park, so a push or pop pays for the shared parking only. The shards lie next to each
+ * other in one buffer, aligned by hand, since over-aligned new is not available before C++17.
+ */
+template<typename ValueType,
+         typename MutexType = std::mutex,
+         typename ConditionType = std::condition_variable,
+         typename SynchronizationPolicy = queue_policy::mpmc>
+struct ShardedBoundedQueue
+  {
+  using value_type      = ValueType;
+  using reference       = value_type &;
+  using const_reference = value_type const &;
+  using size_type       = std::size_t;
+  using shard_type      = BoundedQueue<ValueType, MutexType, queue_detail::unparked, SynchronizationPolicy>;
+
+  using __parking = queue_detail::parking<MutexType, ConditionType>;
+  using __clock = std::chrono::steady_clock;
+
+  explicit ShardedBoundedQueue(size_type const shardCapacity,
+                               size_type const shards = std::max(1u, std::thread::hardware_concurrency()))
+    : m_shardCapacity{shardCapacity},
+      m_storage{new unsigned char[(shards ? shards : throw std::invalid_argument{"Tried to create ShardedBoundedQueue without shards"})
+                                  * sizeof(shard_type) + alignof(shard_type)]}
+    {
+    void * first = m_storage.get();
+    auto space = shards * sizeof(shard_type) + alignof(shard_type);
+    m_shards = static_cast<shard_type *>(std::align(alignof(shard_type), shards * sizeof(shard_type), first, space));
+
+    for(; m_shardCount < shards; ++m_shardCount)
+      {
+      try
+        {
+        new (&m_shards[m_shardCount]) shard_type{shardCapacity};
+        }
+      catch(...)
+        {
+        destroy();
+        throw;
+        }
+      }
+    }
+
+  ShardedBoundedQueue(ShardedBoundedQueue const &) = delete;
+  ShardedBoundedQueue & operator=(ShardedBoundedQueue const &) = delete;
+
+  ~ShardedBoundedQueue()
+    {
+    destroy();
+    }
+
+  auto shards() const noexcept
+    {
+    return m_shardCount;
+    }
+
+  auto capacity() const noexcept
+    {
+    return m_shardCount * m_shardCapacity;
+    }
+
+  /**
+   * The sum of the shard sizes. While other threads operate on the queue, this is only a snapshot.
+   */
+  auto size() const
+    {
+    auto total = size_type{};
+
+    for(auto shard = m_shards; shard != m_shards + m_shardCount; ++shard)
+      {
+      total += shard->size();
+      }
+
+    return total;
+    }
+
+  auto empty() const
+    {
+    return std::all_of(m_shards, m_shards + m_shardCount, [](auto const & shard){ return shard.empty(); });
+    }
+
+  auto full() const
+    {
+    return std::all_of(m_shards, m_shards + m_shardCount, [](auto const & shard){ return shard.full(); });
+    }
+
+  auto closed() const noexcept
+    {
+    return m_closed.load(std::memory_order_acquire);
+    }
+
+  auto close()
+    {
+    m_closed.store(true, std::memory_order_release);
+
+    for(auto shard = m_shards; shard != m_shards + m_shardCount; ++shard)
+      {
+      shard->close();
+      }
+
+    m_parking.wake_all();
+    }
+
+  auto push(value_type const & elem)
+    {
+    do_push(elem);
+    }
+
+  auto push(value_type && elem)
+    {
+    do_push(std::move(elem));
+    }
+
+  value_type pop()
+    {
+    boost::optional<value_type> element{};
+
+    if(!consume([&](value_type & front){ element.emplace(std::move(front)); }))
+      {
+      throw queue_closed{"ShardedBoundedQueue is closed and drained"};
+      }
+
+    return std::move(*element);
+    }
+
+  auto try_push(value_type const & elem)
+    {
+    return do_try_push(elem);
+    }
+
+  auto try_push(value_type && elem)
+    {
+    return do_try_push(std::move(elem));
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_push_for(value_type const & elem, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return retry_until([&]{ return do_try_push(elem); }, [&]{ return closed(); }, __clock::now() + timeout, [&](auto remaining){
+      m_parking.wait_for_space([&]{ return push_ready(); }, remaining);
+    });
+    }
+
+  auto try_pop(value_type & target)
+    {
+    return try_consume([&](value_type & front){ target = std::move(front); });
+    }
+
+  template<typename RepresentationType, typename Period>
+  auto try_pop_for(value_type & target, std::chrono::duration<RepresentationType, Period> const & timeout)
+    {
+    return retry_until([&]{ return try_pop(target); }, [&]{ return drained(); }, __clock::now() + timeout, [&](auto remaining){
+      m_parking.wait_for_elements([&]{ return pop_ready(); }, remaining);
+    });
+    }
+
+  /**
+   * Returns false once the queue is closed and all shards are drained.
+   */
+  template<typename ConsumerType>
+  auto consume(ConsumerType && consumer)
+    {
+    while(!try_consume(consumer))
+      {
+      if(drained())
+        {
+        return false;
+        }
+
+      m_parking.wait_for_elements([&]{ return pop_ready(); });
+      }
+
+    return true;
+    }
+
+  template<typename ConsumerType>
+  auto try_consume(ConsumerType && consumer)
+    {
+    auto const local = local_shard();
+
+    for(size_type offset{}; offset < m_shardCount; ++offset)
+      {
+      if(m_shards[(local + offset) % m_shardCount].try_consume(consumer))
+        {
+        m_parking.wake_producer();
+        return true;
+        }
+      }
+
+    return false;
+    }
+
+  private:
+    size_type local_shard() const noexcept
+      {
+      return queue_detail::thread_ticket() % m_shardCount;
+      }
+
+    auto destroy() noexcept
+      {
+      while(m_shardCount)
+        {
+        m_shards[--m_shardCount].~shard_type();
+        }
+      }
+
+    /*
+     * A shard accepts no pushes once it is closed, so a closed and empty shard stays empty.
+     */
+    auto drained() const
+      {
+      return std::all_of(m_shards, m_shards + m_shardCount, [](auto const & shard){ return shard.closed() && shard.empty(); });
+      }
+
+    auto push_ready() const
+      {
+      return closed() || !full();
+      }
+
+    auto pop_ready() const
+      {
+      return drained() || !empty();
+      }
+
+    template<typename ElementType>
+    auto do_push(ElementType && elem)
+      {
+      while(!do_try_push(std::forward<ElementType>(elem)))
+        {
+        if(closed())
+          {
+          throw queue_closed{"Tried to push to a closed ShardedBoundedQueue"};
+          }
+
+        m_parking.wait_for_space([&]{ return push_ready(); });
+        }
+      }
+
+    /*
+     * A failed push into a shard leaves the element untouched, so it can be offered to the next shard.
+     */
+    template<typename ElementType>
+    auto do_try_push(ElementType && elem)
+      {
+      auto const local = local_shard();
+
+      for(size_type offset{}; offset < m_shardCount; ++offset)
+        {
+        if(m_shards[(local + offset) % m_shardCount].try_push(std::forward<ElementType>(elem)))
+          {
+          m_parking.wake_consumer();
+          return true;
+          }
+        }
+
+      return false;
+      }
+
+    template<typename AttemptType, typename FinishedType, typename WaitOperation>
+    static auto retry_until(AttemptType && attempt, FinishedType && finished, __clock::time_point const deadline, WaitOperation && wait)
+      {
+      while(!attempt())
+        {
+        auto const remaining = deadline - __clock::now();
+        if(finished() || remaining <= __clock::duration::zero())
+          {
+          return false;
+          }
+
+        wait(remaining);
+        }
+
+      return true;
+      }
+
+    size_type m_shardCapacity;
+    std::unique_ptr<unsigned char[]> m_storage;
+    shard_type * m_shards{};
+    size_type m_shardCount{};
+    std::atomic<bool> m_closed{};
+
+    alignas(queue_layout::cache_line_size) __parking m_parking{};
+  };
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef __FMO__SPINNING_CONDITION
+#define __FMO__SPINNING_CONDITION
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <thread>
+
+namespace wait_strategy
+  {
+  inline void cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+    }
+
+  /**
+   * A drop-in replacement for the ConditionType of BoundedQueue that re-checks the predicate before it sleeps.
+   *
+   * The first SpinCount rounds release the lock and back off with an exponentially growing number of pause
+   * instructions, the next YieldCount rounds yield the processor instead. A condition that Parks then blocks on a
+   * condition variable, otherwise it keeps yielding. Notifications only reach the kernel when a thread actually
+   * sleeps. As with every BoundedQueue policy, the notifying thread must have held the waiter's lock after changing
+   * the state it notifies about.
+   */
+  template<std::size_t SpinCount, std::size_t YieldCount, bool Parks>
+  struct spinning_condition
+    {
+    template<typename LockType, typename PredicateType>
+    void wait(LockType & lock, PredicateType ready)
+      {
+      for(std::size_t round{}; !ready(); ++round)
+        {
+        if(Parks && round >= SpinCount + YieldCount)
+          {
+          park(lock, ready);
+          return;
+          }
+
+        back_off(lock, round);
+        }
+      }
+
+    template<typename LockType, typename RepresentationType, typename Period, typename PredicateType>
+    bool wait_for(LockType & lock, std::chrono::duration<RepresentationType, Period> const & timeout, PredicateType ready)
+      {
+      auto const deadline = std::chrono::steady_clock::now() + timeout;
+
+      for(std::size_t round{}; !ready(); ++round)
+        {
+        if(std::chrono::steady_clock::now() >= deadline)
+          {
+          return false;
+          }
+
+        if(Parks && round >= SpinCount + YieldCount)
+          {
+          return park_until(lock, deadline, ready);
+          }
+
+        back_off(lock, round);
+        }
+
+      return true;
+      }
+
+    void notify_one()
+      {
+      if(Parks && m_sleepers.load(std::memory_order_relaxed))
+        {
+        m_condition.notify_one();
+        }
+      }
+
+    void notify_all()
+      {
+      if(Parks && m_sleepers.load(std::memory_order_relaxed))
+        {
+        m_condition.notify_all();
+        }
+      }
+
+    private:
+      template<typename LockType>
+      static void back_off(LockType & lock, std::size_t const round)
+        {
+        lock.unlock();
+
+        if(round < SpinCount)
+          {
+          for(auto pause = std::size_t{1} << std::min<std::size_t>(round, 6); pause; --pause)
+            {
+            cpu_relax();
+            }
+          }
+        else
+          {
+          std::this_thread::yield();
+          }
+
+        lock.lock();
+        }
+
+      template<typename LockType, typename PredicateType>
+      void park(LockType & lock, PredicateType ready)
+        {
+        m_sleepers.fetch_add(1, std::memory_order_relaxed);
+        m_condition.wait(lock, ready);
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+      template<typename LockType, typename TimePoint, typename PredicateType>
+      bool park_until(LockType & lock, TimePoint const & deadline, PredicateType ready)
+        {
+        m_sleepers.fetch_add(1, std::memory_order_relaxed);
+        auto const isReady = m_condition.wait_until(lock, deadline, ready);
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        return isReady;
+        }
+
+      std::condition_variable_any m_condition{};
+      std::atomic<std::size_t> m_sleepers{};
+    };
+
+  using busy_spin = spinning_condition<std::numeric_limits<std::size_t>::max(), 0, false>;
+  using spin_then_yield = spinning_condition<64, std::numeric_limits<std::size_t>::max(), false>;
+  using spin_then_block = spinning_condition<64, 8, true>;
+  using block = std::condition_variable;
+  }
+
+#endif
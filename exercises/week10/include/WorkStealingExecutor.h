@@ -0,0 +1,257 @@
+#ifndef __FMO__WORK_STEALING_EXECUTOR
+#define __FMO__WORK_STEALING_EXECUTOR
+
+#include "BoundedQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * A thread pool in which every worker owns a local deque of tasks.
+ *
+ * Tasks submitted by a worker go to its own deque, the worker takes them back in LIFO order. Tasks submitted
+ * from any other thread go through a bounded injection queue, so a submitter blocks while the pool is saturated.
+ * A worker without local work first takes from the injection queue and then steals the oldest task of another
+ * worker. Workers only sleep when they found nothing anywhere.
+ *
+ * Destroying the executor runs all tasks submitted so far, including the ones they spawn, and joins the workers.
+ * A task passed to submit() must not throw, use async() for tasks that may.
+ */
+template<typename MutexType = std::mutex, typename ConditionType = std::condition_variable>
+struct WorkStealingExecutor
+  {
+  using size_type = std::size_t;
+  using task_type = std::function<void()>;
+
+  using __mutex = MutexType;
+  using __guard = std::lock_guard<__mutex>;
+  using __injection = BoundedQueue<task_type, MutexType, ConditionType, queue_policy::mpmc>;
+  using __parking = queue_detail::parking<MutexType, ConditionType>;
+
+  explicit WorkStealingExecutor(size_type const workers = std::max(1u, std::thread::hardware_concurrency()),
+                                size_type const injectionCapacity = 1024)
+    : m_injection{injectionCapacity}
+    {
+    if(!workers)
+      {
+      throw std::invalid_argument{"Tried to create WorkStealingExecutor without workers"};
+      }
+
+    for(size_type index{}; index < workers; ++index)
+      {
+      m_workers.emplace_back(new __worker{});
+      }
+
+    for(size_type index{}; index < workers; ++index)
+      {
+      m_workers[index]->thread = std::thread{[this, index]{ run(index); }};
+      }
+    }
+
+  WorkStealingExecutor(WorkStealingExecutor const &) = delete;
+  WorkStealingExecutor & operator=(WorkStealingExecutor const &) = delete;
+
+  ~WorkStealingExecutor()
+    {
+    m_stopping.store(true);
+    m_injection.close();
+    m_parking.wake_all();
+
+    for(auto & worker : m_workers)
+      {
+      worker->thread.join();
+      }
+    }
+
+  auto size() const noexcept
+    {
+    return m_workers.size();
+    }
+
+  /**
+   * Blocks while the injection queue is full, unless called from one of the workers. Throws queue_closed once the
+   * executor is being destroyed.
+   */
+  auto submit(task_type task)
+    {
+    if(auto const worker = current())
+      {
+      push_local(*worker, std::move(task));
+      return;
+      }
+
+    m_injection.push(std::move(task));
+    announce();
+    }
+
+  auto try_submit(task_type task)
+    {
+    if(auto const worker = current())
+      {
+      push_local(*worker, std::move(task));
+      return true;
+      }
+
+    if(!m_injection.try_push(std::move(task)))
+      {
+      return false;
+      }
+
+    announce();
+    return true;
+    }
+
+  template<typename FunctionType>
+  auto async(FunctionType && function)
+    {
+    using result_type = std::result_of_t<std::decay_t<FunctionType>()>;
+
+    auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<FunctionType>(function));
+    auto result = task->get_future();
+    submit([task]{ (*task)(); });
+
+    return result;
+    }
+
+  private:
+    /*
+     * Workers are allocated one by one. The trailing padding keeps the next allocation off the cache line of the
+     * deque, since over-aligned new is not available before C++17.
+     */
+    struct __worker
+      {
+      __mutex mutex{};
+      std::deque<task_type> tasks{};
+      WorkStealingExecutor * owner{};
+      std::thread thread{};
+      unsigned char padding[queue_layout::cache_line_size];
+      };
+
+    static __worker * & current_worker() noexcept
+      {
+      static thread_local __worker * worker{};
+      return worker;
+      }
+
+    __worker * current() const noexcept
+      {
+      auto const worker = current_worker();
+      return worker && worker->owner == this ? worker : nullptr;
+      }
+
+    auto run(size_type const index)
+      {
+      auto & self = *m_workers[index];
+      self.owner = this;
+      current_worker() = &self;
+
+      task_type task{};
+
+      for(;;)
+        {
+        if(find_task(index, task))
+          {
+          m_pending.fetch_sub(1);
+          task();
+          task = nullptr;
+          continue;
+          }
+
+        if(m_stopping.load() && m_pending.load() <= 0)
+          {
+          return;
+          }
+
+        m_parking.wait_for_elements([&]{ return m_pending.load() > 0 || m_stopping.load(); });
+        }
+      }
+
+    /*
+     * The own deque first, newest task first, since its data is most likely still in the cache. Then the
+     * injection queue and finally the oldest task of every other worker, starting with the next one.
+     */
+    auto find_task(size_type const index, task_type & task)
+      {
+      if(pop_local(*m_workers[index], task) || m_injection.try_pop(task))
+        {
+        return true;
+        }
+
+      for(size_type offset{1}; offset < m_workers.size(); ++offset)
+        {
+        if(steal(*m_workers[(index + offset) % m_workers.size()], task))
+          {
+          return true;
+          }
+        }
+
+      return false;
+      }
+
+    auto push_local(__worker & worker, task_type && task)
+      {
+        {
+        __guard guard{worker.mutex};
+        worker.tasks.push_back(std::move(task));
+        }
+
+      announce();
+      }
+
+    static auto pop_local(__worker & worker, task_type & task)
+      {
+      __guard guard{worker.mutex};
+      if(worker.tasks.empty())
+        {
+        return false;
+        }
+
+      task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      return true;
+      }
+
+    static auto steal(__worker & victim, task_type & task)
+      {
+      __guard guard{victim.mutex};
+      if(victim.tasks.empty())
+        {
+        return false;
+        }
+
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+      }
+
+    /*
+     * m_pending counts queued tasks. It is raised after the task became visible, so it may briefly drop below
+     * zero when a worker takes the task first.
+     */
+    auto announce()
+      {
+      m_pending.fetch_add(1);
+      m_parking.wake_consumer();
+      }
+
+    std::vector<std::unique_ptr<__worker>> m_workers{};
+    __injection m_injection;
+    std::atomic<std::ptrdiff_t> m_pending{};
+    std::atomic<bool> m_stopping{};
+
+    alignas(queue_layout::cache_line_size) __parking m_parking{};
+  };
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef PRIORITY_BOUNDED_QUEUE_SUITE_H_
+#define PRIORITY_BOUNDED_QUEUE_SUITE_H_
+
+#include <cute/cute_suite.h>
+
+extern cute::suite make_suite_priority_bounded_queue_suite();
+
+
+#endif
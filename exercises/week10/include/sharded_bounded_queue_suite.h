@@ -0,0 +1,9 @@
+#ifndef SHARDED_BOUNDED_QUEUE_SUITE_H_
+#define SHARDED_BOUNDED_QUEUE_SUITE_H_
+
+#include <cute/cute_suite.h>
+
+extern cute::suite make_suite_sharded_bounded_queue_suite();
+
+
+#endif
@@ -26,7 +26,10 @@ std::ostream & operator<<(std::ostream& out, std::future_status const & status)
 }
 
 }
-std::future<void> launchProducer(std::size_t start, std::size_t end, BoundedQueue<unsigned>& small_queue) {
+using MpmcQueue = BoundedQueue<unsigned, std::mutex, std::condition_variable, queue_policy::mpmc>;
+
+template<typename Queue>
+std::future<void> launchProducer(std::size_t start, std::size_t end, Queue& small_queue) {
 	return std::async(std::launch::async, [&, start, end]() mutable {
 		while (start < end) {
 			small_queue.push(start++);
@@ -34,10 +37,10 @@ std::future<void> launchProducer(std::size_t start, std::size_t end, BoundedQueu
 	});
 }
 
-template<typename T>
-std::future<std::vector<T>> launchConsumer(std::size_t nOfElements, BoundedQueue<T>& small_queue) {
+template<typename Queue>
+std::future<std::vector<typename Queue::value_type>> launchConsumer(std::size_t nOfElements, Queue& small_queue) {
 	return std::async(std::launch::async, [&, nOfElements]() {
-		std::vector<unsigned> popped_elements {};
+		std::vector<typename Queue::value_type> popped_elements {};
 		for (auto i = 0u; i < nOfElements; i++) {
 			auto result = small_queue.pop();
 			popped_elements.push_back(result);
@@ -46,11 +49,12 @@ std::future<std::vector<T>> launchConsumer(std::size_t nOfElements, BoundedQueue
 	});
 }
 
-void test_one_producer_and_one_consumer() {
+template<typename Queue>
+void one_producer_and_one_consumer() {
 	const std::size_t nOfElements = 1000;
 	std::vector<unsigned> expected(nOfElements, 0);
 	std::iota(std::begin(expected), std::end(expected), 0);
-	BoundedQueue<unsigned> small_queue { 1 };
+	Queue small_queue { 1 };
 	auto producer = launchProducer(0, nOfElements, small_queue);
 	auto consumer = launchConsumer(nOfElements, small_queue);
 	ASSERT_NOT_EQUAL_TO(std::future_status::timeout, producer.wait_for(std::chrono::seconds { 1 }));
@@ -59,11 +63,20 @@ void test_one_producer_and_one_consumer() {
 	ASSERT_EQUAL(expected, popped_elements);
 }
 
-void test_two_producers_and_one_consumer() {
+void test_one_producer_and_one_consumer() {
+	one_producer_and_one_consumer<BoundedQueue<unsigned>>();
+}
+
+void test_mpmc_one_producer_and_one_consumer() {
+	one_producer_and_one_consumer<MpmcQueue>();
+}
+
+template<typename Queue>
+void two_producers_and_one_consumer() {
 	const std::size_t nOfElements = 1000;
 	std::vector<unsigned> expected(nOfElements, 0);
 	std::iota(std::begin(expected), std::end(expected), 0);
-	BoundedQueue<unsigned> small_queue { 10 };
+	Queue small_queue { 10 };
 	auto producer1 = launchProducer(0, nOfElements / 2, small_queue);
 	auto producer2 = launchProducer(nOfElements / 2, nOfElements, small_queue);
 	auto consumer = launchConsumer(nOfElements, small_queue);
@@ -76,6 +89,14 @@ void test_two_producers_and_one_consumer() {
 	ASSERT_EQUAL(expected, popped_elements);
 }
 
+void test_two_producers_and_one_consumer() {
+	two_producers_and_one_consumer<BoundedQueue<unsigned>>();
+}
+
+void test_mpmc_two_producers_and_one_consumer() {
+	two_producers_and_one_consumer<MpmcQueue>();
+}
+
 template<typename T>
 std::vector<T> combine_and_sort(std::vector<std::future<std::vector<T>>>& parts) {
 	std::vector<T> result {};
@@ -87,11 +108,12 @@ std::vector<T> combine_and_sort(std::vector<std::future<std::vector<T>>>& parts)
 	return result;
 }
 
-void test_one_producer_two_consumers() {
+template<typename Queue>
+void one_producer_two_consumers() {
 	const std::size_t nOfElements = 1000;
 	std::vector<unsigned> expected(nOfElements, 0);
 	std::iota(std::begin(expected), std::end(expected), 0);
-	BoundedQueue<unsigned> small_queue { 10 };
+	Queue small_queue { 10 };
 	auto producer = launchProducer(0, nOfElements, small_queue);
 	std::vector<std::future<std::vector<unsigned>>>consumers {};
 	consumers.push_back(launchConsumer(nOfElements / 2, small_queue));
@@ -106,12 +128,21 @@ void test_one_producer_two_consumers() {
 	ASSERT_EQUAL(expected, popped_elements);
 }
 
-void test_ten_producers_ten_consumers() {
+void test_one_producer_two_consumers() {
+	one_producer_two_consumers<BoundedQueue<unsigned>>();
+}
+
+void test_mpmc_one_producer_two_consumers() {
+	one_producer_two_consumers<MpmcQueue>();
+}
+
+template<typename Queue>
+void ten_producers_ten_consumers() {
 	const std::size_t nOfElements = 10000;
 	const std::size_t sliceSize = nOfElements / 10;
 	std::vector<unsigned> expected(nOfElements, 0);
 	std::iota(std::begin(expected), std::end(expected), 0);
-	BoundedQueue<unsigned> queue { 10 };
+	Queue queue { 10 };
 	std::vector<std::future<void>> producers { };
 	std::vector<std::future<std::vector<unsigned>>>consumers {};
 	for (auto i = 0u; i < 10; i++) {
@@ -130,9 +161,18 @@ void test_ten_producers_ten_consumers() {
 	ASSERT_EQUAL(expected, popped_elements);
 }
 
+void test_ten_producers_ten_consumers() {
+	ten_producers_ten_consumers<BoundedQueue<unsigned>>();
+}
 
-void test_blocked_produced_unblocks() {
-	BoundedQueue<unsigned> queue { 1 };
+void test_mpmc_ten_producers_ten_consumers() {
+	ten_producers_ten_consumers<MpmcQueue>();
+}
+
+
+template<typename Queue>
+void blocked_produced_unblocks() {
+	Queue queue { 1 };
 	queue.push(1);
 
 	auto f = std::async(std::launch::async, [&](){
@@ -144,8 +184,17 @@ void test_blocked_produced_unblocks() {
 	ASSERT_EQUAL(2, queue.pop());
 }
 
-void test_blocked_consumer_unblocks() {
-	BoundedQueue<unsigned> queue { 1 };
+void test_blocked_produced_unblocks() {
+	blocked_produced_unblocks<BoundedQueue<unsigned>>();
+}
+
+void test_mpmc_blocked_produced_unblocks() {
+	blocked_produced_unblocks<MpmcQueue>();
+}
+
+template<typename Queue>
+void blocked_consumer_unblocks() {
+	Queue queue { 1 };
 
 	auto f = std::async(std::launch::async, [&](){
 		std::this_thread::sleep_for(std::chrono::milliseconds{50});
@@ -155,6 +204,14 @@ void test_blocked_consumer_unblocks() {
 	ASSERT_EQUAL(1, queue.pop());
 }
 
+void test_blocked_consumer_unblocks() {
+	blocked_consumer_unblocks<BoundedQueue<unsigned>>();
+}
+
+void test_mpmc_blocked_consumer_unblocks() {
+	blocked_consumer_unblocks<MpmcQueue>();
+}
+
 cute::suite make_suite_bounded_queue_multi_threaded_suite() {
 	cute::suite s;
 	s.push_back(CUTE(test_one_producer_and_one_consumer));
@@ -163,6 +220,12 @@ cute::suite make_suite_bounded_queue_multi_threaded_suite() {
 	s.push_back(CUTE(test_ten_producers_ten_consumers));
 	s.push_back(CUTE(test_blocked_produced_unblocks));
 	s.push_back(CUTE(test_blocked_consumer_unblocks));
+	s.push_back(CUTE(test_mpmc_one_producer_and_one_consumer));
+	s.push_back(CUTE(test_mpmc_two_producers_and_one_consumer));
+	s.push_back(CUTE(test_mpmc_one_producer_two_consumers));
+	s.push_back(CUTE(test_mpmc_ten_producers_ten_consumers));
+	s.push_back(CUTE(test_mpmc_blocked_produced_unblocks));
+	s.push_back(CUTE(test_mpmc_blocked_consumer_unblocks));
 	return s;
 }
 
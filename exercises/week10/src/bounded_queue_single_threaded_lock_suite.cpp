@@ -2,7 +2,9 @@
 
 #include <cute/cute.h>
 #include "BoundedQueue.h"
+#include <iterator>
 #include <type_traits>
+#include <vector>
 
 struct single_threaded_test_mutex {
 	static unsigned lock_count;
@@ -131,7 +133,7 @@ void reset_counters() {
 }
 
 void test_push_rvalue_aquires_lock() {
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
 	reset_counters();
 
 	queue.push(1);
@@ -140,7 +142,7 @@ void test_push_rvalue_aquires_lock() {
 }
 
 void test_push_rvalue_releases_lock() {
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
 	reset_counters();
 
 	queue.push(1);
@@ -150,7 +152,7 @@ void test_push_rvalue_releases_lock() {
 
 void test_push_lvalue_aquires_lock() {
 	int i { 1 };
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
 	reset_counters();
 
 	queue.push(i);
@@ -160,7 +162,7 @@ void test_push_lvalue_aquires_lock() {
 
 void test_push_lvalue_releases_lock() {
 	int i { 1 };
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
 	reset_counters();
 
 	queue.push(i);
@@ -169,7 +171,7 @@ void test_push_lvalue_releases_lock() {
 }
 
 void test_pop_aquires_lock() {
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
 	queue.push(1);
 	reset_counters();
 
@@ -179,7 +181,7 @@ void test_pop_aquires_lock() {
 }
 
 void test_pop_releases_lock() {
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
 	queue.push(1);
 	reset_counters();
 
@@ -188,58 +190,58 @@ void test_pop_releases_lock() {
 	ASSERT_EQUAL(1, single_threaded_test_mutex::unlock_count);
 }
 
-void test_empty_aquires_lock() {
+void test_empty_does_not_aquire_lock() {
 	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	reset_counters();
 
 	queue.empty();
 
-	ASSERT_EQUAL(1, single_threaded_test_mutex::lock_count);
+	ASSERT_EQUAL(0, single_threaded_test_mutex::lock_count);
 }
 
-void test_empty_releases_lock() {
+void test_empty_does_not_release_lock() {
 	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	reset_counters();
 
 	queue.empty();
 
-	ASSERT_EQUAL(1, single_threaded_test_mutex::unlock_count);
+	ASSERT_EQUAL(0, single_threaded_test_mutex::unlock_count);
 }
 
-void test_full_aquires_lock() {
+void test_full_does_not_aquire_lock() {
 	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	reset_counters();
 
 	queue.full();
 
-	ASSERT_EQUAL(1, single_threaded_test_mutex::lock_count);
+	ASSERT_EQUAL(0, single_threaded_test_mutex::lock_count);
 }
 
-void test_full_releases_lock() {
+void test_full_does_not_release_lock() {
 	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	reset_counters();
 
 	queue.full();
 
-	ASSERT_EQUAL(1, single_threaded_test_mutex::unlock_count);
+	ASSERT_EQUAL(0, single_threaded_test_mutex::unlock_count);
 }
 
-void test_size_aquires_lock() {
+void test_size_does_not_aquire_lock() {
 	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	reset_counters();
 
 	queue.size();
 
-	ASSERT_EQUAL(1, single_threaded_test_mutex::lock_count);
+	ASSERT_EQUAL(0, single_threaded_test_mutex::lock_count);
 }
 
-void test_size_releases_lock() {
+void test_size_does_not_release_lock() {
 	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<>> queue { 5 };
 	reset_counters();
 
 	queue.size();
 
-	ASSERT_EQUAL(1, single_threaded_test_mutex::unlock_count);
+	ASSERT_EQUAL(0, single_threaded_test_mutex::unlock_count);
 }
 
 void test_swap_aquires_both_locks() {
@@ -270,7 +272,7 @@ void test_swap_aquires_tries_multiple_times_to_try_lock() {
 }
 
 void test_swap_successful_after_delayed_lock() {
-	BoundedQueue<int, single_threaded_count_down_mutex<1>, single_threaded_condition_variable<1, 1>> queue { 5 }, other { 4 };
+	BoundedQueue<int, single_threaded_count_down_mutex<1>, single_threaded_condition_variable<1, 0>> queue { 5 }, other { 4 };
 	other.push(17);
 	reset_counters();
 
@@ -280,7 +282,7 @@ void test_swap_successful_after_delayed_lock() {
 }
 
 void test_try_push_rvalue_aquires_lock() {
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	reset_counters();
 
 	queue.try_push(1);
@@ -289,7 +291,7 @@ void test_try_push_rvalue_aquires_lock() {
 }
 
 void test_try_push_rvalue_releases_lock() {
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	reset_counters();
 
 	queue.try_push(1);
@@ -299,7 +301,7 @@ void test_try_push_rvalue_releases_lock() {
 
 void test_try_push_lvalue_aquires_lock() {
 	int i { 1 };
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	reset_counters();
 
 	queue.try_push(i);
@@ -309,7 +311,7 @@ void test_try_push_lvalue_aquires_lock() {
 
 void test_try_push_lvalue_releases_lock() {
 	int i { 1 };
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	reset_counters();
 
 	queue.try_push(i);
@@ -318,7 +320,7 @@ void test_try_push_lvalue_releases_lock() {
 }
 
 void test_try_pop_aquires_lock() {
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	queue.push(1);
 	int result { };
 	reset_counters();
@@ -329,7 +331,7 @@ void test_try_pop_aquires_lock() {
 }
 
 void test_try_pop_releases_lock() {
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
 	queue.push(1);
 	int result { };
 	reset_counters();
@@ -378,7 +380,7 @@ void test_symmetric_lock_and_unlock_on_move_constructor() {
 }
 
 void test_symmetric_lock_and_unlock_on_copy_assignment() {
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 1>> queue { 5 }, copy { 4 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 }, copy { 4 };
 	reset_counters();
 
 	copy = queue;
@@ -397,7 +399,7 @@ void test_symmetric_lock_and_unlock_on_move_assignment() {
 
 void test_try_push_for_aquires_lock_on_empty_queue() {
 	int i { 1 };
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
 	reset_counters();
 
 	queue.try_push_for(i, std::chrono::milliseconds { 1 });
@@ -407,7 +409,7 @@ void test_try_push_for_aquires_lock_on_empty_queue() {
 
 void test_try_push_for_releases_lock_on_empty_queue() {
 	int i { 1 };
-	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 1>> queue { 5 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
 	reset_counters();
 
 	queue.try_push_for(i, std::chrono::milliseconds { 1 });
@@ -477,6 +479,48 @@ void test_try_pop_for_releases_lock_on_full_queue() {
 	ASSERT_EQUAL(2, single_threaded_test_mutex::unlock_count);
 }
 
+void test_push_range_aquires_lock_once() {
+	std::vector<int> values { 1, 2, 3 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
+	reset_counters();
+
+	queue.push_range(values.begin(), values.end());
+
+	ASSERT_EQUAL(1, single_threaded_test_mutex::lock_count);
+}
+
+void test_pop_into_aquires_lock_once() {
+	std::vector<int> values { 1, 2, 3 }, popped { };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<1, 0>> queue { 5 };
+	queue.push_range(values.begin(), values.end());
+	reset_counters();
+
+	queue.pop_into(std::back_inserter(popped), 5);
+
+	ASSERT_EQUAL(1, single_threaded_test_mutex::lock_count);
+}
+
+void test_try_push_range_releases_lock() {
+	std::vector<int> values { 1, 2, 3 };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
+	reset_counters();
+
+	queue.try_push_range(values.begin(), values.end());
+
+	ASSERT_EQUAL(1, single_threaded_test_mutex::unlock_count);
+}
+
+void test_try_pop_into_releases_lock() {
+	std::vector<int> values { 1, 2, 3 }, popped { };
+	BoundedQueue<int, single_threaded_test_mutex, single_threaded_condition_variable<0, 0>> queue { 5 };
+	queue.try_push_range(values.begin(), values.end());
+	reset_counters();
+
+	queue.try_pop_into(std::back_inserter(popped), 2);
+
+	ASSERT_EQUAL(1, single_threaded_test_mutex::unlock_count);
+}
+
 cute::suite make_suite_bounded_queue_single_threaded_lock_suite() {
 	cute::suite s;
 	s.push_back(CUTE(test_push_rvalue_aquires_lock));
@@ -485,12 +529,12 @@ cute::suite make_suite_bounded_queue_single_threaded_lock_suite() {
 	s.push_back(CUTE(test_push_lvalue_releases_lock));
 	s.push_back(CUTE(test_pop_aquires_lock));
 	s.push_back(CUTE(test_pop_releases_lock));
-	s.push_back(CUTE(test_empty_aquires_lock));
-	s.push_back(CUTE(test_empty_releases_lock));
-	s.push_back(CUTE(test_full_aquires_lock));
-	s.push_back(CUTE(test_full_releases_lock));
-	s.push_back(CUTE(test_size_aquires_lock));
-	s.push_back(CUTE(test_size_releases_lock));
+	s.push_back(CUTE(test_empty_does_not_aquire_lock));
+	s.push_back(CUTE(test_empty_does_not_release_lock));
+	s.push_back(CUTE(test_full_does_not_aquire_lock));
+	s.push_back(CUTE(test_full_does_not_release_lock));
+	s.push_back(CUTE(test_size_does_not_aquire_lock));
+	s.push_back(CUTE(test_size_does_not_release_lock));
 	s.push_back(CUTE(test_swap_aquires_both_locks));
 	s.push_back(CUTE(test_swap_releases_two_locks));
 	s.push_back(CUTE(test_try_push_rvalue_aquires_lock));
@@ -515,6 +559,10 @@ cute::suite make_suite_bounded_queue_single_threaded_lock_suite() {
 	s.push_back(CUTE(test_try_push_for_releases_lock_on_full_queue));
 	s.push_back(CUTE(test_try_pop_for_aquires_lock_on_full_queue));
 	s.push_back(CUTE(test_try_pop_for_releases_lock_on_full_queue));
+	s.push_back(CUTE(test_push_range_aquires_lock_once));
+	s.push_back(CUTE(test_pop_into_aquires_lock_once));
+	s.push_back(CUTE(test_try_push_range_releases_lock));
+	s.push_back(CUTE(test_try_pop_into_releases_lock));
 	return s;
 }
 
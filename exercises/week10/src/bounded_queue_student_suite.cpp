@@ -1,17 +1,1451 @@
 #include "bounded_queue_student_suite.h"
 
 #include "BoundedQueue.h"
+#include "HugePageAllocator.h"
+#include "QueueSelector.h"
+#include "SpinningCondition.h"
+#include "WorkStealingExecutor.h"
 #include <cute/cute.h>
 
-//TODO: Add your own tests here
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+using SpscQueue = BoundedQueue<unsigned, std::mutex, std::condition_variable, queue_policy::spsc>;
+using MpmcQueue = BoundedQueue<unsigned, std::mutex, std::condition_variable, queue_policy::mpmc>;
 
+struct Immovable {
+	Immovable(unsigned first, unsigned second) : first { first }, second { second } {
+		nOfConstructions++;
+	}
 
+	Immovable(Immovable const &) = delete;
+	Immovable & operator=(Immovable const &) = delete;
 
-cute::suite make_suite_bounded_queue_student_suite(){
-	cute::suite s;
-	return s;
+	~Immovable() {
+		nOfDestructions++;
+	}
+
+	unsigned first;
+	unsigned second;
+
+	static unsigned nOfConstructions;
+	static unsigned nOfDestructions;
+};
+
+unsigned Immovable::nOfConstructions { 0 };
+unsigned Immovable::nOfDestructions { 0 };
+
+void resetImmovableCounters() {
+	Immovable::nOfConstructions = 0;
+	Immovable::nOfDestructions = 0;
+}
+
+template<typename Queue>
+void emplace_and_consume_in_place() {
+	resetImmovableCounters();
+	{
+		Queue queue { 2 };
+		queue.emplace(1, 2);
+		ASSERT(queue.try_emplace(3, 4));
+		ASSERT(!queue.try_emplace(5, 6));
+		unsigned sum { };
+		queue.consume([&](Immovable & element) { sum += element.first + element.second; });
+		ASSERT(queue.try_consume([&](Immovable & element) { sum += element.first + element.second; }));
+		ASSERT(!queue.try_consume([&](Immovable &) { FAILM("consumer called on empty queue"); }));
+		ASSERT_EQUAL(10, sum);
+		ASSERT_EQUAL(2, Immovable::nOfDestructions);
+	}
+	ASSERT_EQUAL(2, Immovable::nOfConstructions);
+	ASSERT_EQUAL(2, Immovable::nOfDestructions);
+}
+
+template<typename Queue>
+void consume_removes_element_when_consumer_throws() {
+	resetImmovableCounters();
+	Queue queue { 2 };
+	queue.emplace(1, 2);
+	ASSERT_THROWS(queue.consume([](Immovable &) { throw std::runtime_error { "consumer failed" }; }), std::runtime_error);
+	ASSERT(queue.empty());
+	ASSERT_EQUAL(1, Immovable::nOfDestructions);
+}
+
+void test_spsc_queue_pops_in_fifo_order() {
+	SpscQueue queue { 3 };
+	queue.push(1);
+	queue.push(2);
+	queue.push(3);
+	ASSERT_EQUAL(1, queue.pop());
+	ASSERT_EQUAL(2, queue.pop());
+	ASSERT_EQUAL(3, queue.pop());
+}
+
+void test_spsc_queue_wraps_around() {
+	SpscQueue queue { 2 };
+	for (auto i = 0u; i < 10; i++) {
+		queue.push(i);
+		ASSERT_EQUAL(i, queue.pop());
+	}
+	ASSERT(queue.empty());
+}
+
+void test_spsc_queue_with_non_power_of_two_size_wraps_around() {
+	SpscQueue queue { 3 };
+	for (auto i = 0u; i < 10; i++) {
+		queue.push(i);
+		queue.push(i + 1);
+		ASSERT_EQUAL(i, queue.pop());
+		ASSERT_EQUAL(i + 1, queue.pop());
+	}
+	ASSERT(queue.empty());
+}
+
+void test_spsc_queue_try_push_fails_when_full() {
+	SpscQueue queue { 1 };
+	ASSERT(queue.try_push(1));
+	ASSERT(!queue.try_push(2));
+	ASSERT(queue.full());
+}
+
+void test_spsc_queue_try_pop_fails_when_empty() {
+	SpscQueue queue { 1 };
+	unsigned result { 42 };
+	ASSERT(!queue.try_pop(result));
+	ASSERT_EQUAL(42, result);
+}
+
+void test_spsc_queue_try_pop_for_times_out_when_empty() {
+	SpscQueue queue { 1 };
+	unsigned result { };
+	ASSERT(!queue.try_pop_for(result, std::chrono::milliseconds { 1 }));
+}
+
+void test_spsc_queue_try_push_for_times_out_when_full() {
+	SpscQueue queue { 1 };
+	queue.push(1);
+	ASSERT(!queue.try_push_for(2, std::chrono::milliseconds { 1 }));
+	ASSERT_EQUAL(1, queue.size());
+}
+
+void test_spsc_queue_copy_contains_same_elements() {
+	SpscQueue queue { 3 };
+	queue.push(1);
+	queue.push(2);
+	queue.pop();
+	queue.push(3);
+	SpscQueue copy { queue };
+	ASSERT_EQUAL(2, copy.size());
+	ASSERT_EQUAL(2, copy.pop());
+	ASSERT_EQUAL(3, copy.pop());
+}
+
+void test_spsc_queue_copy_after_threads_joined_keeps_elements_and_closed_state() {
+	SpscQueue queue { 4 };
+	auto producer = std::async(std::launch::async, [&] {
+		for (auto value = 0u; value < 10; value++) {
+			queue.push(value);
+		}
+	});
+	auto consumer = std::async(std::launch::async, [&] {
+		for (auto count = 0u; count < 7; count++) {
+			queue.pop();
+		}
+	});
+	producer.get();
+	consumer.get();
+	queue.close();
+	SpscQueue copy { queue };
+	SpscQueue assigned { 1 };
+	assigned = queue;
+	ASSERT(copy.closed());
+	ASSERT(assigned.closed());
+	for (auto value = 7u; value < 10; value++) {
+		ASSERT_EQUAL(value, copy.pop());
+		ASSERT_EQUAL(value, assigned.pop());
+	}
+}
+
+void test_spsc_queue_one_producer_and_one_consumer() {
+	const std::size_t nOfElements = 10000;
+	std::vector<unsigned> expected(nOfElements, 0);
+	std::iota(std::begin(expected), std::end(expected), 0);
+	SpscQueue queue { 1 };
+	auto producer = std::async(std::launch::async, [&] {
+		for (auto i = 0u; i < nOfElements; i++) {
+			queue.push(i);
+		}
+	});
+	auto consumer = std::async(std::launch::async, [&] {
+		std::vector<unsigned> popped_elements { };
+		for (auto i = 0u; i < nOfElements; i++) {
+			popped_elements.push_back(queue.pop());
+		}
+		return popped_elements;
+	});
+	ASSERT(std::future_status::timeout != producer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT(std::future_status::timeout != consumer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT_EQUAL(expected, consumer.get());
+}
+
+void test_spsc_queue_blocked_consumer_unblocks() {
+	SpscQueue queue { 1 };
+	auto f = std::async(std::launch::async, [&] {
+		std::this_thread::sleep_for(std::chrono::milliseconds { 50 });
+		queue.push(1);
+	});
+	ASSERT_EQUAL(1, queue.pop());
+}
+
+void test_spsc_queue_blocked_producer_unblocks() {
+	SpscQueue queue { 1 };
+	queue.push(1);
+	auto f = std::async(std::launch::async, [&] {
+		std::this_thread::sleep_for(std::chrono::milliseconds { 50 });
+		queue.pop();
+	});
+	queue.push(2);
+	ASSERT_EQUAL(2, queue.pop());
+}
+
+void test_mpmc_queue_pops_in_fifo_order() {
+	MpmcQueue queue { 3 };
+	queue.push(1);
+	queue.push(2);
+	queue.push(3);
+	ASSERT_EQUAL(1, queue.pop());
+	ASSERT_EQUAL(2, queue.pop());
+	ASSERT_EQUAL(3, queue.pop());
+}
+
+void test_mpmc_queue_wraps_around() {
+	MpmcQueue queue { 3 };
+	for (auto i = 0u; i < 10; i++) {
+		queue.push(i);
+		ASSERT_EQUAL(i, queue.pop());
+	}
+	ASSERT(queue.empty());
+}
+
+void test_mpmc_queue_with_power_of_two_size_wraps_around() {
+	MpmcQueue queue { 4 };
+	for (auto i = 0u; i < 10; i++) {
+		queue.push(i);
+		queue.push(i + 1);
+		queue.push(i + 2);
+		ASSERT_EQUAL(i, queue.pop());
+		ASSERT_EQUAL(i + 1, queue.pop());
+		ASSERT_EQUAL(i + 2, queue.pop());
+	}
+	ASSERT(queue.empty());
+}
+
+void test_mpmc_queue_try_push_fails_when_full() {
+	MpmcQueue queue { 2 };
+	ASSERT(queue.try_push(1));
+	ASSERT(queue.try_push(2));
+	ASSERT(!queue.try_push(3));
+	ASSERT(queue.full());
+}
+
+void test_mpmc_queue_try_pop_for_times_out_when_empty() {
+	MpmcQueue queue { 1 };
+	unsigned result { 42 };
+	ASSERT(!queue.try_pop_for(result, std::chrono::milliseconds { 1 }));
+	ASSERT_EQUAL(42, result);
+}
+
+void test_mpmc_queue_try_push_for_times_out_when_full() {
+	MpmcQueue queue { 1 };
+	queue.push(1);
+	ASSERT(!queue.try_push_for(2, std::chrono::milliseconds { 1 }));
+	ASSERT_EQUAL(1, queue.size());
+}
+
+void test_mpmc_queue_copy_and_move_keep_elements() {
+	MpmcQueue queue { 3 };
+	queue.push(1);
+	queue.push(2);
+	MpmcQueue copy { queue };
+	MpmcQueue moved { std::move(queue) };
+	ASSERT_EQUAL(1, copy.pop());
+	ASSERT_EQUAL(2, copy.pop());
+	ASSERT_EQUAL(1, moved.pop());
+	ASSERT_EQUAL(2, moved.pop());
+}
+
+void test_mpmc_queue_copy_after_threads_joined_keeps_elements_and_closed_state() {
+	MpmcQueue queue { 4 };
+	auto producer = std::async(std::launch::async, [&] {
+		for (auto value = 0u; value < 10; value++) {
+			queue.push(value);
+		}
+	});
+	auto consumer = std::async(std::launch::async, [&] {
+		for (auto count = 0u; count < 7; count++) {
+			queue.pop();
+		}
+	});
+	producer.get();
+	consumer.get();
+	queue.close();
+	MpmcQueue copy { queue };
+	MpmcQueue swapped { 1 };
+	swapped.swap(queue);
+	ASSERT(copy.closed());
+	ASSERT(swapped.closed());
+	for (auto value = 7u; value < 10; value++) {
+		ASSERT_EQUAL(value, copy.pop());
+		ASSERT_EQUAL(value, swapped.pop());
+	}
+}
+
+void test_mpmc_queue_ten_producers_ten_consumers() {
+	const std::size_t nOfElements = 10000;
+	const std::size_t sliceSize = nOfElements / 10;
+	std::vector<unsigned> expected(nOfElements, 0);
+	std::iota(std::begin(expected), std::end(expected), 0);
+	MpmcQueue queue { 10 };
+	std::vector<std::future<void>> producers { };
+	std::vector<std::future<std::vector<unsigned>>> consumers { };
+	for (auto i = 0u; i < 10; i++) {
+		producers.push_back(std::async(std::launch::async, [&, i] {
+			for (auto value = sliceSize * i; value < sliceSize * (i + 1); value++) {
+				queue.push(value);
+			}
+		}));
+		consumers.push_back(std::async(std::launch::async, [&] {
+			std::vector<unsigned> popped_elements { };
+			for (auto n = 0u; n < sliceSize; n++) {
+				popped_elements.push_back(queue.pop());
+			}
+			return popped_elements;
+		}));
+	}
+	for (auto & producer : producers) {
+		ASSERT(std::future_status::timeout != producer.wait_for(std::chrono::seconds { 1 }));
+	}
+	std::vector<unsigned> popped_elements { };
+	for (auto & consumer : consumers) {
+		ASSERT(std::future_status::timeout != consumer.wait_for(std::chrono::seconds { 1 }));
+		auto part = consumer.get();
+		popped_elements.insert(std::end(popped_elements), std::begin(part), std::end(part));
+	}
+	std::sort(std::begin(popped_elements), std::end(popped_elements));
+	ASSERT_EQUAL(expected, popped_elements);
+}
+
+void test_mpmc_queue_blocked_consumer_unblocks() {
+	MpmcQueue queue { 1 };
+	auto f = std::async(std::launch::async, [&] {
+		std::this_thread::sleep_for(std::chrono::milliseconds { 50 });
+		queue.push(1);
+	});
+	ASSERT_EQUAL(1, queue.pop());
+}
+
+void test_try_push_range_stops_when_full() {
+	std::vector<unsigned> values { 1, 2, 3, 4 };
+	BoundedQueue<unsigned> queue { 3 };
+	auto rest = queue.try_push_range(values.begin(), values.end());
+	ASSERT_EQUAL(3, std::distance(values.begin(), rest));
+	ASSERT(queue.full());
+}
+
+void test_try_pop_into_pops_at_most_maximum_count() {
+	std::vector<unsigned> values { 1, 2, 3 }, popped { };
+	BoundedQueue<unsigned> queue { 3 };
+	queue.push_range(values.begin(), values.end());
+	ASSERT_EQUAL(2, queue.try_pop_into(std::back_inserter(popped), 2));
+	ASSERT_EQUAL((std::vector<unsigned> { 1, 2 }), popped);
+	ASSERT_EQUAL(1, queue.size());
+}
+
+void test_try_pop_into_on_empty_queue_pops_nothing() {
+	std::vector<unsigned> popped { };
+	BoundedQueue<unsigned> queue { 3 };
+	ASSERT_EQUAL(0, queue.try_pop_into(std::back_inserter(popped), 2));
+	ASSERT(popped.empty());
+}
+
+void test_try_push_range_for_times_out_with_remaining_elements() {
+	std::vector<unsigned> values { 1, 2, 3 };
+	BoundedQueue<unsigned> queue { 2 };
+	auto rest = queue.try_push_range_for(values.begin(), values.end(), std::chrono::milliseconds { 1 });
+	ASSERT_EQUAL(2, std::distance(values.begin(), rest));
+}
+
+void test_try_pop_into_for_times_out_when_empty() {
+	std::vector<unsigned> popped { };
+	BoundedQueue<unsigned> queue { 2 };
+	ASSERT_EQUAL(0, queue.try_pop_into_for(std::back_inserter(popped), 2, std::chrono::milliseconds { 1 }));
+}
+
+void test_push_range_larger_than_queue_with_batch_consumer() {
+	const std::size_t nOfElements = 10000;
+	std::vector<unsigned> expected(nOfElements, 0);
+	std::iota(std::begin(expected), std::end(expected), 0);
+	BoundedQueue<unsigned> queue { 16 };
+	auto producer = std::async(std::launch::async, [&] {
+		queue.push_range(expected.begin(), expected.end());
+	});
+	std::vector<unsigned> popped_elements { };
+	while (popped_elements.size() < nOfElements) {
+		queue.pop_into(std::back_inserter(popped_elements), 7);
+	}
+	ASSERT(std::future_status::timeout != producer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT_EQUAL(expected, popped_elements);
+}
+
+void test_emplace_and_consume_in_place() {
+	emplace_and_consume_in_place<BoundedQueue<Immovable>>();
+}
+
+void test_spsc_emplace_and_consume_in_place() {
+	emplace_and_consume_in_place<BoundedQueue<Immovable, std::mutex, std::condition_variable, queue_policy::spsc>>();
+}
+
+void test_mpmc_emplace_and_consume_in_place() {
+	emplace_and_consume_in_place<BoundedQueue<Immovable, std::mutex, std::condition_variable, queue_policy::mpmc>>();
+}
+
+void test_consume_removes_element_when_consumer_throws() {
+	consume_removes_element_when_consumer_throws<BoundedQueue<Immovable>>();
+}
+
+void test_spsc_consume_removes_element_when_consumer_throws() {
+	consume_removes_element_when_consumer_throws<BoundedQueue<Immovable, std::mutex, std::condition_variable, queue_policy::spsc>>();
+}
+
+void test_mpmc_consume_removes_element_when_consumer_throws() {
+	consume_removes_element_when_consumer_throws<BoundedQueue<Immovable, std::mutex, std::condition_variable, queue_policy::mpmc>>();
+}
+
+template<typename Queue>
+void hand_over_elements_between_two_threads() {
+	const std::size_t nOfElements = 1000;
+	std::vector<unsigned> expected(nOfElements, 0);
+	std::iota(std::begin(expected), std::end(expected), 0);
+	Queue queue { 4 };
+	auto producer = std::async(std::launch::async, [&] {
+		for (auto i = 0u; i < nOfElements; i++) {
+			queue.push(i);
+		}
+	});
+	std::vector<unsigned> popped_elements { };
+	for (auto i = 0u; i < nOfElements; i++) {
+		popped_elements.push_back(queue.pop());
+	}
+	ASSERT(std::future_status::timeout != producer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT_EQUAL(expected, popped_elements);
+}
+
+template<typename Condition>
+void timed_waits_expire() {
+	BoundedQueue<unsigned, std::mutex, Condition> queue { 1 };
+	unsigned result { };
+	ASSERT(!queue.try_pop_for(result, std::chrono::milliseconds { 2 }));
+	queue.push(1);
+	ASSERT(!queue.try_push_for(2, std::chrono::milliseconds { 2 }));
+}
+
+void test_busy_spin_queue_hands_over_elements() {
+	hand_over_elements_between_two_threads<BoundedQueue<unsigned, std::mutex, wait_strategy::busy_spin>>();
+}
+
+void test_spin_then_yield_queue_hands_over_elements() {
+	hand_over_elements_between_two_threads<BoundedQueue<unsigned, std::mutex, wait_strategy::spin_then_yield>>();
+}
+
+void test_spin_then_block_queue_hands_over_elements() {
+	hand_over_elements_between_two_threads<BoundedQueue<unsigned, std::mutex, wait_strategy::spin_then_block>>();
+}
+
+void test_spin_then_block_spsc_queue_hands_over_elements() {
+	hand_over_elements_between_two_threads<BoundedQueue<unsigned, std::mutex, wait_strategy::spin_then_block, queue_policy::spsc>>();
+}
+
+void test_spin_then_block_mpmc_queue_hands_over_elements() {
+	hand_over_elements_between_two_threads<BoundedQueue<unsigned, std::mutex, wait_strategy::spin_then_block, queue_policy::mpmc>>();
+}
+
+void test_busy_spin_timed_waits_expire() {
+	timed_waits_expire<wait_strategy::busy_spin>();
+}
+
+void test_spin_then_block_timed_waits_expire() {
+	timed_waits_expire<wait_strategy::spin_then_block>();
+}
+
+template<typename Queue>
+void close_wakes_blocked_consumer() {
+	Queue queue { 4 };
+	auto consumer = std::async(std::launch::async, [&] {
+		return queue.consume([](unsigned) {});
+	});
+	queue.close();
+	ASSERT(std::future_status::timeout != consumer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT(!consumer.get());
+}
+
+template<typename Queue>
+void close_wakes_blocked_producer() {
+	Queue queue { 1 };
+	queue.push(1);
+	auto producer = std::async(std::launch::async, [&] {
+		queue.push(2);
+	});
+	queue.close();
+	ASSERT(std::future_status::timeout != producer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT_THROWS(producer.get(), queue_closed);
+}
+
+template<typename Queue>
+void closed_queue_drains_remaining_elements() {
+	Queue queue { 4 };
+	queue.push(1);
+	queue.push(2);
+	queue.close();
+	ASSERT(queue.closed());
+	ASSERT(!queue.try_push(3));
+	ASSERT_THROWS(queue.push(3), queue_closed);
+	ASSERT_EQUAL(1, queue.pop());
+	unsigned element { };
+	ASSERT(queue.try_pop_for(element, std::chrono::seconds { 1 }));
+	ASSERT_EQUAL(2, element);
+	ASSERT(!queue.try_pop_for(element, std::chrono::seconds { 1 }));
+	ASSERT_THROWS(queue.pop(), queue_closed);
+}
+
+template<typename Queue>
+void workers_shut_down_after_close() {
+	const unsigned nOfElements = 1000;
+	Queue queue { 8 };
+	auto worker = [&] {
+		unsigned sum { };
+		while (queue.consume([&](unsigned element) { sum += element; })) {
+		}
+		return sum;
+	};
+	auto first = std::async(std::launch::async, worker);
+	auto second = std::async(std::launch::async, worker);
+	for (auto i = 0u; i < nOfElements; i++) {
+		queue.push(i);
+	}
+	queue.close();
+	ASSERT(std::future_status::timeout != first.wait_for(std::chrono::seconds { 1 }));
+	ASSERT(std::future_status::timeout != second.wait_for(std::chrono::seconds { 1 }));
+	ASSERT_EQUAL(nOfElements * (nOfElements - 1) / 2, first.get() + second.get());
+}
+
+void test_close_wakes_blocked_consumer() {
+	close_wakes_blocked_consumer<BoundedQueue<unsigned>>();
+}
+
+void test_spsc_close_wakes_blocked_consumer() {
+	close_wakes_blocked_consumer<SpscQueue>();
+}
+
+void test_mpmc_close_wakes_blocked_consumer() {
+	close_wakes_blocked_consumer<MpmcQueue>();
+}
+
+void test_close_wakes_blocked_producer() {
+	close_wakes_blocked_producer<BoundedQueue<unsigned>>();
+}
+
+void test_spsc_close_wakes_blocked_producer() {
+	close_wakes_blocked_producer<SpscQueue>();
+}
+
+void test_mpmc_close_wakes_blocked_producer() {
+	close_wakes_blocked_producer<MpmcQueue>();
+}
+
+void test_closed_queue_drains_remaining_elements() {
+	closed_queue_drains_remaining_elements<BoundedQueue<unsigned>>();
+}
+
+void test_spsc_closed_queue_drains_remaining_elements() {
+	closed_queue_drains_remaining_elements<SpscQueue>();
+}
+
+void test_mpmc_closed_queue_drains_remaining_elements() {
+	closed_queue_drains_remaining_elements<MpmcQueue>();
+}
+
+void test_workers_shut_down_after_close() {
+	workers_shut_down_after_close<BoundedQueue<unsigned>>();
+}
+
+void test_mpmc_workers_shut_down_after_close() {
+	workers_shut_down_after_close<MpmcQueue>();
+}
+
+void test_closed_queue_stops_push_range() {
+	BoundedQueue<unsigned> queue { 4 };
+	std::vector<unsigned> const elements { 1, 2, 3 };
+	queue.close();
+	ASSERT(std::begin(elements) == queue.try_push_range(std::begin(elements), std::end(elements)));
+	ASSERT(std::begin(elements) == queue.try_push_range_for(std::begin(elements), std::end(elements), std::chrono::seconds { 1 }));
+	std::vector<unsigned> popped { };
+	ASSERT_EQUAL(0, queue.pop_into(std::back_inserter(popped), 4));
+}
+
+void test_executor_runs_all_submitted_tasks() {
+	const unsigned nOfTasks = 1000;
+	std::atomic<unsigned> executed { 0 };
+	{
+		WorkStealingExecutor<> executor { 4, 8 };
+		for (auto i = 0u; i < nOfTasks; i++) {
+			executor.submit([&] { ++executed; });
+		}
+	}
+	ASSERT_EQUAL(nOfTasks, executed.load());
+}
+
+void test_executor_runs_tasks_spawned_by_tasks() {
+	std::atomic<unsigned> executed { 0 };
+	{
+		WorkStealingExecutor<> executor { 4, 8 };
+		for (auto i = 0u; i < 10; i++) {
+			executor.submit([&] {
+				for (auto j = 0u; j < 100; j++) {
+					executor.submit([&] { ++executed; });
+				}
+			});
+		}
+	}
+	ASSERT_EQUAL(1000, executed.load());
 }
 
+void test_executor_async_returns_result() {
+	WorkStealingExecutor<> executor { 2 };
+	auto result = executor.async([] { return 42; });
+	ASSERT_EQUAL(42, result.get());
+}
+
+void test_executor_async_propagates_exception() {
+	WorkStealingExecutor<> executor { 2 };
+	auto result = executor.async([]() -> int { throw std::logic_error { "failed" }; });
+	ASSERT_THROWS(result.get(), std::logic_error);
+}
+
+void test_executor_try_submit_fails_when_injection_queue_is_full() {
+	std::promise<void> release { };
+	std::promise<void> started { };
+	auto blocker = release.get_future().share();
+	WorkStealingExecutor<> executor { 1, 1 };
+	executor.submit([&] {
+		started.set_value();
+		blocker.wait();
+	});
+	started.get_future().wait();
+	ASSERT(executor.try_submit([] {}));
+	ASSERT(!executor.try_submit([] {}));
+	release.set_value();
+}
+
+void test_executor_without_workers_throws() {
+	ASSERT_THROWS(WorkStealingExecutor<> { 0 }, std::invalid_argument);
+}
+
+struct manual_executor {
+	void submit(std::function<void()> task) {
+		tasks.push_back(std::move(task));
+	}
+
+	std::size_t run() {
+		std::size_t executed { };
+		while (!tasks.empty()) {
+			auto task = std::move(tasks.front());
+			tasks.pop_front();
+			task();
+			++executed;
+		}
+		return executed;
+	}
+
+	std::deque<std::function<void()>> tasks { };
+};
+
+void test_async_pop_completes_on_executor() {
+	manual_executor executor { };
+	BoundedQueue<unsigned> queue { 2 };
+	queue.push(17);
+	boost::optional<unsigned> popped { };
+	queue.async_pop(executor, [&](boost::optional<unsigned> element) { popped = element; });
+	ASSERT(!popped);
+	executor.run();
+	ASSERT_EQUAL(17, popped.value());
+}
+
+void test_async_pop_resumes_when_element_arrives() {
+	manual_executor executor { };
+	BoundedQueue<unsigned> queue { 2 };
+	boost::optional<unsigned> popped { };
+	queue.async_pop(executor, [&](boost::optional<unsigned> element) { popped = element; });
+	executor.run();
+	ASSERT(!popped);
+	queue.push(42);
+	executor.run();
+	ASSERT_EQUAL(42, popped.value());
+	ASSERT(queue.empty());
+}
+
+void test_async_push_resumes_when_space_is_available() {
+	manual_executor executor { };
+	BoundedQueue<unsigned> queue { 1 };
+	queue.push(1);
+	bool pushed { false };
+	queue.async_push(2, executor, [&](bool success) { pushed = success; });
+	executor.run();
+	ASSERT(!pushed);
+	ASSERT_EQUAL(1, queue.pop());
+	executor.run();
+	ASSERT(pushed);
+	ASSERT_EQUAL(2, queue.pop());
+}
+
+void test_close_completes_parked_async_operations() {
+	manual_executor executor { };
+	BoundedQueue<unsigned> queue { 1 };
+	boost::optional<unsigned> popped { 0 };
+	queue.async_pop(executor, [&](boost::optional<unsigned> element) { popped = element; });
+	executor.run();
+	queue.close();
+	executor.run();
+	ASSERT(!popped);
+	bool pushed { true };
+	queue.async_push(1, executor, [&](bool success) { pushed = success; });
+	executor.run();
+	ASSERT(!pushed);
+}
 
+void test_many_async_consumers_share_few_threads() {
+	const unsigned nOfConsumers = 1000;
+	std::atomic<unsigned> sum { 0 };
+	BoundedQueue<unsigned> queue { 16 };
+	{
+		WorkStealingExecutor<> executor { 2 };
+		for (auto i = 0u; i < nOfConsumers; i++) {
+			queue.async_pop(executor, [&](boost::optional<unsigned> element) { sum += element.value(); });
+		}
+		for (auto i = 0u; i < nOfConsumers; i++) {
+			queue.push(i);
+		}
+	}
+	ASSERT_EQUAL(nOfConsumers * (nOfConsumers - 1) / 2, sum.load());
+}
 
+void test_close_resumes_more_parked_operations_than_the_executor_holds() {
+	const unsigned nOfConsumers = 3000;
+	std::atomic<unsigned> completed { 0 };
+	BoundedQueue<unsigned> queue { 16 };
+	{
+		WorkStealingExecutor<> executor { 2, 4 };
+		for (auto i = 0u; i < nOfConsumers; i++) {
+			queue.async_pop(executor, [&](boost::optional<unsigned> element) {
+				if (!element) {
+					++completed;
+				}
+			});
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds { 50 });
+		queue.close();
+		while (completed.load() != nOfConsumers) {
+			std::this_thread::yield();
+		}
+	}
+	ASSERT_EQUAL(nOfConsumers, completed.load());
+}
+
+void test_select_returns_queue_with_elements() {
+	BoundedQueue<unsigned> control { 2 }, bulk { 2 };
+	queue_selector selector { };
+	ASSERT_EQUAL(0, selector.watch(control));
+	ASSERT_EQUAL(1, selector.watch(bulk));
+	bulk.push(1);
+	ASSERT_EQUAL(1, selector.select());
+}
+
+void test_select_prefers_first_watched_queue() {
+	BoundedQueue<unsigned> control { 2 }, bulk { 2 };
+	bulk.push(1);
+	control.push(2);
+	queue_selector selector { };
+	selector.watch(control);
+	selector.watch(bulk);
+	ASSERT_EQUAL(0, selector.select());
+	control.pop();
+	ASSERT_EQUAL(1, selector.select());
+}
+
+void test_select_for_times_out_without_elements() {
+	BoundedQueue<unsigned> control { 2 }, bulk { 2 };
+	queue_selector selector { };
+	selector.watch(control);
+	selector.watch(bulk);
+	ASSERT(!selector.select_for(std::chrono::milliseconds { 10 }));
+}
+
+void test_select_wakes_up_when_element_arrives() {
+	BoundedQueue<unsigned> control { 2 }, bulk { 2 };
+	queue_selector selector { };
+	selector.watch(control);
+	selector.watch(bulk);
+	auto dispatcher = std::async(std::launch::async, [&] {
+		return selector.select();
+	});
+	bulk.push(1);
+	ASSERT(std::future_status::timeout != dispatcher.wait_for(std::chrono::seconds { 1 }));
+	ASSERT_EQUAL(1, dispatcher.get());
+}
+
+void test_select_reports_closed_queue() {
+	BoundedQueue<unsigned> control { 2 }, bulk { 2 };
+	queue_selector selector { };
+	selector.watch(control);
+	selector.watch(bulk);
+	control.close();
+	ASSERT_EQUAL(0, selector.select());
+}
+
+void test_select_sees_elements_swapped_into_watched_queue() {
+	BoundedQueue<unsigned> control { 2 }, bulk { 2 }, filled { 2 };
+	filled.push(1);
+	queue_selector selector { };
+	selector.watch(control);
+	selector.watch(bulk);
+	control.swap(filled);
+	ASSERT_EQUAL(0, selector.select());
+	control = BoundedQueue<unsigned> { 2 };
+	ASSERT(!selector.select_for(std::chrono::milliseconds { 10 }));
+}
+
+void test_select_survives_concurrent_consumer() {
+	const unsigned nOfRounds = 20000;
+	BoundedQueue<unsigned> control { 2 };
+	queue_selector selector { };
+	selector.watch(control);
+	std::atomic<bool> done { false };
+	auto consumer = std::async(std::launch::async, [&] {
+		unsigned element { };
+		while (!done.load()) {
+			control.try_push(1);
+			control.try_pop(element);
+		}
+	});
+	for (auto round = 0u; round < nOfRounds; round++) {
+		auto const selected = selector.select_for(std::chrono::microseconds { 10 });
+		ASSERT(!selected || *selected == 0);
+	}
+	done.store(true);
+	consumer.get();
+}
+
+void test_queue_cannot_be_watched_by_two_selectors() {
+	BoundedQueue<unsigned> control { 2 };
+	queue_selector first { };
+	first.watch(control);
+	{
+		queue_selector second { };
+		ASSERT_THROWS(second.watch(control), std::logic_error);
+	}
+	control.push(1);
+	ASSERT_EQUAL(0, first.select());
+}
+
+void test_select_dispatches_elements_of_several_queues() {
+	const unsigned nOfElements = 1000;
+	BoundedQueue<unsigned> control { 4 }, bulk { 4 };
+	queue_selector selector { };
+	selector.watch(control);
+	selector.watch(bulk);
+	auto producer = std::async(std::launch::async, [&] {
+		for (auto i = 0u; i < nOfElements; i++) {
+			(i % 2 ? control : bulk).push(i);
+		}
+	});
+	unsigned sum { }, element { };
+	for (auto received = 0u; received < nOfElements;) {
+		auto & selected = selector.select() ? bulk : control;
+		if (selected.try_pop(element)) {
+			sum += element;
+			++received;
+		}
+	}
+	ASSERT(std::future_status::timeout != producer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT_EQUAL(nOfElements * (nOfElements - 1) / 2, sum);
+}
+
+using CountingQueue = BoundedQueue<unsigned, std::mutex, std::condition_variable, queue_policy::locked, queue_layout::compact, queue_statistics::enabled>;
+
+void test_statistics_count_pushes_and_pops() {
+	CountingQueue queue { 8 };
+	for (unsigned element { }; element < 6; ++element) {
+		queue.push(element);
+	}
+	std::vector<unsigned> target(4);
+	ASSERT_EQUAL(4, queue.pop_into(target.begin(), 4));
+	queue.pop();
+	auto const statistics = queue.statistics();
+	ASSERT_EQUAL(6, statistics.pushes);
+	ASSERT_EQUAL(5, statistics.pops);
+	ASSERT_EQUAL(6, statistics.highWaterMark);
+	ASSERT_EQUAL(0, statistics.blockedPushes);
+	ASSERT_EQUAL(0, statistics.blockedPops);
+}
+
+void test_statistics_record_occupancy() {
+	CountingQueue queue { 8 };
+	for (unsigned element { }; element < 8; ++element) {
+		queue.push(element);
+	}
+	auto const occupancy = queue.statistics().occupancy;
+	for (auto bucket = 1u; bucket < queue_statistics::occupancy_buckets - 1; ++bucket) {
+		ASSERT_EQUAL(1, occupancy[bucket]);
+	}
+	ASSERT_EQUAL(0, occupancy[0]);
+	ASSERT_EQUAL(2, occupancy[queue_statistics::occupancy_buckets - 1]);
+}
+
+void test_statistics_record_timeouts() {
+	CountingQueue queue { 1 };
+	unsigned element { };
+	ASSERT(!queue.try_pop_for(element, std::chrono::milliseconds { 10 }));
+	queue.push(1);
+	ASSERT(!queue.try_push_for(2, std::chrono::milliseconds { 10 }));
+	ASSERT(queue.try_pop_for(element, std::chrono::milliseconds { 10 }));
+	auto const statistics = queue.statistics();
+	ASSERT_EQUAL(1, statistics.popTimeouts);
+	ASSERT_EQUAL(1, statistics.pushTimeouts);
+	ASSERT_EQUAL(1, statistics.blockedPops);
+	ASSERT_EQUAL(1, statistics.blockedPushes);
+	ASSERT(statistics.popWaitTime >= std::chrono::milliseconds { 10 });
+	ASSERT(statistics.pushWaitTime >= std::chrono::milliseconds { 10 });
+}
+
+struct AllocationLog {
+	std::size_t allocations { };
+	std::size_t deallocations { };
+	std::size_t constructions { };
+	std::size_t destructions { };
+};
+
+template<typename T>
+struct LoggingAllocator {
+	using value_type = T;
+
+	explicit LoggingAllocator(AllocationLog & log) : log { &log } {
+	}
+
+	template<typename U>
+	LoggingAllocator(LoggingAllocator<U> const & other) : log { other.log } {
+	}
+
+	T * allocate(std::size_t n) {
+		log->allocations++;
+		return std::allocator<T> { }.allocate(n);
+	}
+
+	void deallocate(T * p, std::size_t n) {
+		log->deallocations++;
+		std::allocator<T> { }.deallocate(p, n);
+	}
+
+	template<typename U, typename... Args>
+	void construct(U * p, Args &&... args) {
+		log->constructions++;
+		::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+	}
+
+	template<typename U>
+	void destroy(U * p) {
+		log->destructions++;
+		p->~U();
+	}
+
+	AllocationLog * log;
+};
+
+template<typename T, typename U>
+bool operator==(LoggingAllocator<T> const & lhs, LoggingAllocator<U> const & rhs) {
+	return lhs.log == rhs.log;
+}
+
+template<typename T, typename U>
+bool operator!=(LoggingAllocator<T> const & lhs, LoggingAllocator<U> const & rhs) {
+	return !(lhs == rhs);
+}
+
+template<typename Policy>
+using LoggingQueue = BoundedQueue<unsigned, std::mutex, std::condition_variable, Policy, typename Policy::default_layout, queue_statistics::disabled, LoggingAllocator<unsigned>>;
+
+template<typename Queue>
+void queue_storage_comes_from_allocator() {
+	AllocationLog log { };
+	{
+		Queue queue { 4, LoggingAllocator<unsigned> { log } };
+		queue.push(1);
+		queue.push(2);
+		ASSERT_EQUAL(1, log.allocations);
+		ASSERT(queue.get_allocator() == LoggingAllocator<unsigned> { log });
+		Queue copy { queue };
+		ASSERT_EQUAL(2, log.allocations);
+		ASSERT_EQUAL(1, copy.pop());
+		Queue moved { std::move(queue) };
+		ASSERT_EQUAL(2, log.allocations);
+		ASSERT_EQUAL(1, moved.pop());
+		copy = moved;
+		ASSERT_EQUAL(3, log.allocations);
+		ASSERT_EQUAL(2, copy.pop());
+	}
+	ASSERT_EQUAL(3, log.deallocations);
+}
+
+void test_queue_storage_comes_from_allocator() {
+	queue_storage_comes_from_allocator<LoggingQueue<queue_policy::locked>>();
+}
+
+void test_spsc_queue_storage_comes_from_allocator() {
+	queue_storage_comes_from_allocator<LoggingQueue<queue_policy::spsc>>();
+}
+
+void test_mpmc_queue_storage_comes_from_allocator() {
+	queue_storage_comes_from_allocator<LoggingQueue<queue_policy::mpmc>>();
+}
+
+template<typename T>
+struct CopyPropagatingAllocator : LoggingAllocator<T> {
+	using propagate_on_container_copy_assignment = std::true_type;
+
+	explicit CopyPropagatingAllocator(AllocationLog & log) : LoggingAllocator<T> { log } {
+	}
+
+	template<typename U>
+	CopyPropagatingAllocator(CopyPropagatingAllocator<U> const & other) : LoggingAllocator<T> { other } {
+	}
+};
+
+template<typename Policy>
+using CopyPropagatingQueue = BoundedQueue<unsigned, std::mutex, std::condition_variable, Policy, typename Policy::default_layout, queue_statistics::disabled, CopyPropagatingAllocator<unsigned>>;
+
+template<typename Policy>
+void assignment_follows_allocator_propagation() {
+	AllocationLog ours { }, theirs { };
+	{
+		LoggingQueue<Policy> queue { 2, LoggingAllocator<unsigned> { ours } };
+		LoggingQueue<Policy> other { 4, LoggingAllocator<unsigned> { theirs } };
+		other.push(1);
+		other.push(2);
+		queue = std::move(other);
+		ASSERT(queue.get_allocator() == LoggingAllocator<unsigned> { ours });
+		ASSERT_EQUAL(2, ours.allocations);
+		ASSERT_EQUAL(2, ours.constructions);
+		ASSERT_EQUAL(1, queue.pop());
+		ASSERT_EQUAL(2, queue.pop());
+	}
+	{
+		CopyPropagatingQueue<Policy> queue { 2, CopyPropagatingAllocator<unsigned> { ours } };
+		CopyPropagatingQueue<Policy> other { 4, CopyPropagatingAllocator<unsigned> { theirs } };
+		other.push(3);
+		queue = other;
+		ASSERT(queue.get_allocator() == CopyPropagatingAllocator<unsigned> { theirs });
+		ASSERT_EQUAL(3, queue.pop());
+	}
+	ASSERT_EQUAL(ours.allocations, ours.deallocations);
+	ASSERT_EQUAL(ours.constructions, ours.destructions);
+	ASSERT_EQUAL(theirs.allocations, theirs.deallocations);
+	ASSERT_EQUAL(theirs.constructions, theirs.destructions);
+}
+
+void test_assignment_follows_allocator_propagation() {
+	assignment_follows_allocator_propagation<queue_policy::locked>();
+}
+
+void test_spsc_assignment_follows_allocator_propagation() {
+	assignment_follows_allocator_propagation<queue_policy::spsc>();
+}
+
+void test_mpmc_assignment_follows_allocator_propagation() {
+	assignment_follows_allocator_propagation<queue_policy::mpmc>();
+}
+
+void test_huge_page_allocator_aligns_large_allocations() {
+	HugePageAllocator<std::size_t> allocator { };
+	auto const count = 3 * HugePageAllocator<std::size_t>::huge_page_size / sizeof(std::size_t) / 2;
+	auto const memory = allocator.allocate(count);
+	ASSERT_EQUAL(0, reinterpret_cast<std::uintptr_t>(memory) % HugePageAllocator<std::size_t>::huge_page_size);
+	std::fill(memory, memory + count, 42);
+	ASSERT_EQUAL(42, memory[count - 1]);
+	allocator.deallocate(memory, count);
+}
+
+void test_huge_page_allocator_serves_small_allocations() {
+	HugePageAllocator<unsigned> allocator { };
+	auto const memory = allocator.allocate(4);
+	std::fill(memory, memory + 4, 1u);
+	ASSERT_EQUAL(4, std::accumulate(memory, memory + 4, 0u));
+	allocator.deallocate(memory, 4);
+	ASSERT(allocator == HugePageAllocator<char> { });
+}
+
+void test_queue_on_huge_pages_hands_over_elements() {
+	const unsigned nOfElements = 1u << 20;
+	BoundedQueue<unsigned, std::mutex, std::condition_variable, queue_policy::spsc, queue_layout::padded, queue_statistics::disabled, HugePageAllocator<unsigned>> queue { nOfElements };
+	for (unsigned element { }; element < nOfElements; ++element) {
+		ASSERT(queue.try_push(element));
+	}
+	ASSERT(queue.full());
+	unsigned element { };
+	for (unsigned expected { }; expected < nOfElements; ++expected) {
+		queue.try_pop(element);
+		if (element != expected) {
+			ASSERT_EQUAL(expected, element);
+		}
+	}
+	ASSERT(queue.empty());
+}
+
+struct Ticket {
+	explicit Ticket(unsigned number) : number { number } {
+	}
+
+	Ticket(Ticket &&) = default;
+	Ticket & operator=(Ticket &&) = delete;
+
+	unsigned number;
+};
+
+template<typename Policy>
+using TicketQueue = BoundedQueue<Ticket, std::mutex, std::condition_variable, Policy>;
+
+template<typename Queue>
+void timed_operations_move_elements() {
+	Queue queue { 2 };
+	ASSERT(queue.try_push_for(Ticket { 1 }, std::chrono::milliseconds { 1 }));
+	ASSERT(queue.try_emplace_for(std::chrono::milliseconds { 1 }, 2u));
+	ASSERT(!queue.try_emplace_for(std::chrono::milliseconds { 1 }, 3u));
+	auto first = queue.try_pop_for(std::chrono::milliseconds { 1 });
+	ASSERT(first);
+	ASSERT_EQUAL(1, first->number);
+	auto second = queue.try_pop();
+	ASSERT(second);
+	ASSERT_EQUAL(2, second->number);
+	ASSERT(!queue.try_pop());
+	ASSERT(!queue.try_pop_for(std::chrono::milliseconds { 1 }));
+}
+
+void test_queue_timed_operations_move_elements() {
+	timed_operations_move_elements<TicketQueue<queue_policy::locked>>();
+}
+
+void test_spsc_queue_timed_operations_move_elements() {
+	timed_operations_move_elements<TicketQueue<queue_policy::spsc>>();
+}
+
+void test_mpmc_queue_timed_operations_move_elements() {
+	timed_operations_move_elements<TicketQueue<queue_policy::mpmc>>();
+}
+
+template<typename Queue>
+void optional_pop_returns_nothing_when_closed() {
+	Queue queue { 2 };
+	queue.emplace(1u);
+	queue.close();
+	ASSERT(!queue.try_push_for(Ticket { 2 }, std::chrono::milliseconds { 1 }));
+	ASSERT_EQUAL(1, queue.try_pop_for(std::chrono::milliseconds { 1 })->number);
+	ASSERT(!queue.try_pop_for(std::chrono::milliseconds { 1 }));
+}
+
+void test_queue_optional_pop_returns_nothing_when_closed() {
+	optional_pop_returns_nothing_when_closed<TicketQueue<queue_policy::locked>>();
+}
+
+void test_spsc_queue_optional_pop_returns_nothing_when_closed() {
+	optional_pop_returns_nothing_when_closed<TicketQueue<queue_policy::spsc>>();
+}
+
+void test_mpmc_queue_optional_pop_returns_nothing_when_closed() {
+	optional_pop_returns_nothing_when_closed<TicketQueue<queue_policy::mpmc>>();
+}
+
+void test_size_can_be_polled_while_elements_are_handed_over() {
+	const unsigned nOfElements = 10000;
+	BoundedQueue<unsigned> queue { 16 };
+	std::atomic<bool> done { false };
+	auto monitor = std::async(std::launch::async, [&] {
+		std::size_t largest { };
+		while (!done.load()) {
+			largest = std::max(largest, queue.size());
+		}
+		return largest;
+	});
+	auto producer = std::async(std::launch::async, [&] {
+		for (unsigned element { }; element < nOfElements; ++element) {
+			queue.push(element);
+		}
+	});
+	for (unsigned expected { }; expected < nOfElements; ++expected) {
+		ASSERT_EQUAL(expected, queue.pop());
+	}
+	producer.get();
+	done.store(true);
+	ASSERT(monitor.get() <= 16);
+	ASSERT(queue.empty());
+}
+
+void test_full_can_be_polled_while_queues_are_swapped() {
+	BoundedQueue<unsigned> queue { 2 }, other { 4 };
+	queue.push(1);
+	queue.push(2);
+	std::atomic<bool> done { false };
+	auto monitor = std::async(std::launch::async, [&] {
+		unsigned fullSeen { };
+		while (!done.load()) {
+			fullSeen += queue.full();
+		}
+		return fullSeen;
+	});
+	for (unsigned round { }; round < 1000; ++round) {
+		queue.swap(other);
+	}
+	done.store(true);
+	monitor.get();
+	ASSERT_EQUAL(2, queue.size());
+	ASSERT(queue.full());
+}
+
+struct CountingCondition {
+	template<typename Lock, typename Predicate>
+	void wait(Lock & lock, Predicate ready) {
+		++waiting;
+		condition.wait(lock, ready);
+		--waiting;
+	}
+
+	void notify_one() {
+		++notifiedOne;
+		condition.notify_one();
+	}
+
+	void notify_all() {
+		++notifiedAll;
+		condition.notify_all();
+	}
+
+	std::condition_variable_any condition { };
+
+	static std::atomic<unsigned> waiting;
+	static std::atomic<unsigned> notifiedOne;
+	static std::atomic<unsigned> notifiedAll;
+};
+
+std::atomic<unsigned> CountingCondition::waiting { 0 };
+std::atomic<unsigned> CountingCondition::notifiedOne { 0 };
+std::atomic<unsigned> CountingCondition::notifiedAll { 0 };
+
+void test_batch_push_wakes_one_consumer_per_element() {
+	BoundedQueue<unsigned, std::mutex, CountingCondition> queue { 4 };
+	std::vector<std::future<unsigned>> consumers { };
+	for (unsigned consumer { }; consumer < 3; ++consumer) {
+		consumers.push_back(std::async(std::launch::async, [&] {
+			return queue.pop();
+		}));
+	}
+	while (CountingCondition::waiting.load() != 3) {
+		std::this_thread::yield();
+	}
+	CountingCondition::notifiedOne = 0;
+	CountingCondition::notifiedAll = 0;
+	std::vector<unsigned> const elements { 1, 2 };
+	queue.push_range(elements.begin(), elements.end());
+	ASSERT_EQUAL(2, CountingCondition::notifiedOne.load());
+	ASSERT_EQUAL(0, CountingCondition::notifiedAll.load());
+	queue.push(3);
+	unsigned sum { };
+	for (auto & consumer : consumers) {
+		sum += consumer.get();
+	}
+	ASSERT_EQUAL(6, sum);
+}
+
+struct CopyBomb {
+	CopyBomb(unsigned value, bool explodes = false) : value { value }, explodes { explodes } {
+	}
+
+	CopyBomb(CopyBomb const & other) : value { other.value }, explodes { other.explodes } {
+		if (explodes) {
+			throw std::runtime_error { "copy failed" };
+		}
+	}
+
+	CopyBomb(CopyBomb &&) = default;
+	CopyBomb & operator=(CopyBomb &&) = default;
+
+	unsigned value;
+	bool explodes;
+};
+
+void test_push_range_signals_pushed_elements_when_copy_throws() {
+	BoundedQueue<CopyBomb, std::mutex, CountingCondition> queue { 4 };
+	auto consumer = std::async(std::launch::async, [&] {
+		return queue.pop().value;
+	});
+	while (CountingCondition::waiting.load() != 1) {
+		std::this_thread::yield();
+	}
+	std::vector<CopyBomb> elements { };
+	elements.emplace_back(1);
+	elements.emplace_back(2, true);
+	ASSERT_THROWS(queue.push_range(elements.begin(), elements.end()), std::runtime_error);
+	auto const status = consumer.wait_for(std::chrono::seconds { 1 });
+	queue.close();
+	ASSERT(std::future_status::timeout != status);
+	ASSERT_EQUAL(1, consumer.get());
+}
+
+struct FailingSink {
+	FailingSink & operator=(unsigned) {
+		if (++assigned == 2) {
+			throw std::runtime_error { "sink full" };
+		}
+		return *this;
+	}
+
+	static unsigned assigned;
+};
+
+unsigned FailingSink::assigned { 0 };
+
+void test_pop_into_signals_freed_slots_when_target_throws() {
+	BoundedQueue<unsigned, std::mutex, CountingCondition> queue { 2 };
+	queue.push(1);
+	queue.push(2);
+	auto producer = std::async(std::launch::async, [&] {
+		queue.push(3);
+	});
+	while (CountingCondition::waiting.load() != 1) {
+		std::this_thread::yield();
+	}
+	FailingSink sinks[2] { };
+	ASSERT_THROWS(queue.pop_into(sinks, 2), std::runtime_error);
+	auto const status = producer.wait_for(std::chrono::seconds { 1 });
+	queue.close();
+	ASSERT(std::future_status::timeout != status);
+	ASSERT_EQUAL(3, queue.pop());
+}
+
+cute::suite make_suite_bounded_queue_student_suite(){
+	cute::suite s;
+	s.push_back(CUTE(test_spsc_queue_pops_in_fifo_order));
+	s.push_back(CUTE(test_spsc_queue_wraps_around));
+	s.push_back(CUTE(test_spsc_queue_with_non_power_of_two_size_wraps_around));
+	s.push_back(CUTE(test_spsc_queue_try_push_fails_when_full));
+	s.push_back(CUTE(test_spsc_queue_try_pop_fails_when_empty));
+	s.push_back(CUTE(test_spsc_queue_try_pop_for_times_out_when_empty));
+	s.push_back(CUTE(test_spsc_queue_try_push_for_times_out_when_full));
+	s.push_back(CUTE(test_spsc_queue_copy_contains_same_elements));
+	s.push_back(CUTE(test_spsc_queue_copy_after_threads_joined_keeps_elements_and_closed_state));
+	s.push_back(CUTE(test_spsc_queue_one_producer_and_one_consumer));
+	s.push_back(CUTE(test_spsc_queue_blocked_consumer_unblocks));
+	s.push_back(CUTE(test_spsc_queue_blocked_producer_unblocks));
+	s.push_back(CUTE(test_mpmc_queue_pops_in_fifo_order));
+	s.push_back(CUTE(test_mpmc_queue_wraps_around));
+	s.push_back(CUTE(test_mpmc_queue_with_power_of_two_size_wraps_around));
+	s.push_back(CUTE(test_mpmc_queue_try_push_fails_when_full));
+	s.push_back(CUTE(test_mpmc_queue_try_pop_for_times_out_when_empty));
+	s.push_back(CUTE(test_mpmc_queue_try_push_for_times_out_when_full));
+	s.push_back(CUTE(test_mpmc_queue_copy_and_move_keep_elements));
+	s.push_back(CUTE(test_mpmc_queue_copy_after_threads_joined_keeps_elements_and_closed_state));
+	s.push_back(CUTE(test_mpmc_queue_ten_producers_ten_consumers));
+	s.push_back(CUTE(test_mpmc_queue_blocked_consumer_unblocks));
+	s.push_back(CUTE(test_try_push_range_stops_when_full));
+	s.push_back(CUTE(test_try_pop_into_pops_at_most_maximum_count));
+	s.push_back(CUTE(test_try_pop_into_on_empty_queue_pops_nothing));
+	s.push_back(CUTE(test_try_push_range_for_times_out_with_remaining_elements));
+	s.push_back(CUTE(test_try_pop_into_for_times_out_when_empty));
+	s.push_back(CUTE(test_push_range_larger_than_queue_with_batch_consumer));
+	s.push_back(CUTE(test_emplace_and_consume_in_place));
+	s.push_back(CUTE(test_spsc_emplace_and_consume_in_place));
+	s.push_back(CUTE(test_mpmc_emplace_and_consume_in_place));
+	s.push_back(CUTE(test_consume_removes_element_when_consumer_throws));
+	s.push_back(CUTE(test_spsc_consume_removes_element_when_consumer_throws));
+	s.push_back(CUTE(test_mpmc_consume_removes_element_when_consumer_throws));
+	s.push_back(CUTE(test_busy_spin_queue_hands_over_elements));
+	s.push_back(CUTE(test_spin_then_yield_queue_hands_over_elements));
+	s.push_back(CUTE(test_spin_then_block_queue_hands_over_elements));
+	s.push_back(CUTE(test_spin_then_block_spsc_queue_hands_over_elements));
+	s.push_back(CUTE(test_spin_then_block_mpmc_queue_hands_over_elements));
+	s.push_back(CUTE(test_busy_spin_timed_waits_expire));
+	s.push_back(CUTE(test_spin_then_block_timed_waits_expire));
+	s.push_back(CUTE(test_close_wakes_blocked_consumer));
+	s.push_back(CUTE(test_spsc_close_wakes_blocked_consumer));
+	s.push_back(CUTE(test_mpmc_close_wakes_blocked_consumer));
+	s.push_back(CUTE(test_close_wakes_blocked_producer));
+	s.push_back(CUTE(test_spsc_close_wakes_blocked_producer));
+	s.push_back(CUTE(test_mpmc_close_wakes_blocked_producer));
+	s.push_back(CUTE(test_closed_queue_drains_remaining_elements));
+	s.push_back(CUTE(test_spsc_closed_queue_drains_remaining_elements));
+	s.push_back(CUTE(test_mpmc_closed_queue_drains_remaining_elements));
+	s.push_back(CUTE(test_workers_shut_down_after_close));
+	s.push_back(CUTE(test_mpmc_workers_shut_down_after_close));
+	s.push_back(CUTE(test_closed_queue_stops_push_range));
+	s.push_back(CUTE(test_executor_runs_all_submitted_tasks));
+	s.push_back(CUTE(test_executor_runs_tasks_spawned_by_tasks));
+	s.push_back(CUTE(test_executor_async_returns_result));
+	s.push_back(CUTE(test_executor_async_propagates_exception));
+	s.push_back(CUTE(test_executor_try_submit_fails_when_injection_queue_is_full));
+	s.push_back(CUTE(test_executor_without_workers_throws));
+	s.push_back(CUTE(test_async_pop_completes_on_executor));
+	s.push_back(CUTE(test_async_pop_resumes_when_element_arrives));
+	s.push_back(CUTE(test_async_push_resumes_when_space_is_available));
+	s.push_back(CUTE(test_close_completes_parked_async_operations));
+	s.push_back(CUTE(test_many_async_consumers_share_few_threads));
+	s.push_back(CUTE(test_close_resumes_more_parked_operations_than_the_executor_holds));
+	s.push_back(CUTE(test_select_returns_queue_with_elements));
+	s.push_back(CUTE(test_select_prefers_first_watched_queue));
+	s.push_back(CUTE(test_select_for_times_out_without_elements));
+	s.push_back(CUTE(test_select_wakes_up_when_element_arrives));
+	s.push_back(CUTE(test_select_reports_closed_queue));
+	s.push_back(CUTE(test_select_sees_elements_swapped_into_watched_queue));
+	s.push_back(CUTE(test_select_survives_concurrent_consumer));
+	s.push_back(CUTE(test_queue_cannot_be_watched_by_two_selectors));
+	s.push_back(CUTE(test_select_dispatches_elements_of_several_queues));
+	s.push_back(CUTE(test_statistics_count_pushes_and_pops));
+	s.push_back(CUTE(test_statistics_record_occupancy));
+	s.push_back(CUTE(test_statistics_record_timeouts));
+	s.push_back(CUTE(test_queue_storage_comes_from_allocator));
+	s.push_back(CUTE(test_spsc_queue_storage_comes_from_allocator));
+	s.push_back(CUTE(test_mpmc_queue_storage_comes_from_allocator));
+	s.push_back(CUTE(test_assignment_follows_allocator_propagation));
+	s.push_back(CUTE(test_spsc_assignment_follows_allocator_propagation));
+	s.push_back(CUTE(test_mpmc_assignment_follows_allocator_propagation));
+	s.push_back(CUTE(test_huge_page_allocator_aligns_large_allocations));
+	s.push_back(CUTE(test_huge_page_allocator_serves_small_allocations));
+	s.push_back(CUTE(test_queue_on_huge_pages_hands_over_elements));
+	s.push_back(CUTE(test_queue_timed_operations_move_elements));
+	s.push_back(CUTE(test_spsc_queue_timed_operations_move_elements));
+	s.push_back(CUTE(test_mpmc_queue_timed_operations_move_elements));
+	s.push_back(CUTE(test_queue_optional_pop_returns_nothing_when_closed));
+	s.push_back(CUTE(test_spsc_queue_optional_pop_returns_nothing_when_closed));
+	s.push_back(CUTE(test_mpmc_queue_optional_pop_returns_nothing_when_closed));
+	s.push_back(CUTE(test_size_can_be_polled_while_elements_are_handed_over));
+	s.push_back(CUTE(test_full_can_be_polled_while_queues_are_swapped));
+	s.push_back(CUTE(test_batch_push_wakes_one_consumer_per_element));
+	s.push_back(CUTE(test_push_range_signals_pushed_elements_when_copy_throws));
+	s.push_back(CUTE(test_pop_into_signals_freed_slots_when_target_throws));
+	return s;
+}
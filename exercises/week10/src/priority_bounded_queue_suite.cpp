@@ -0,0 +1,248 @@
+#include "priority_bounded_queue_suite.h"
+
+#include "PriorityBoundedQueue.h"
+#include <cute/cute.h>
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Task {
+	Task(unsigned lane, unsigned id) : lane { lane }, id { id } {
+		nOfConstructions++;
+	}
+
+	Task(Task const & other) : lane { other.lane }, id { other.id } {
+		nOfConstructions++;
+	}
+
+	Task(Task && other) noexcept : lane { other.lane }, id { other.id } {
+		nOfConstructions++;
+	}
+
+	Task & operator=(Task const &) {
+		nOfAssignments++;
+		return *this;
+	}
+
+	Task & operator=(Task &&) {
+		nOfAssignments++;
+		return *this;
+	}
+
+	~Task() {
+		nOfDestructions++;
+	}
+
+	unsigned lane;
+	unsigned id;
+
+	static unsigned nOfConstructions;
+	static unsigned nOfDestructions;
+	static unsigned nOfAssignments;
+};
+
+unsigned Task::nOfConstructions { 0 };
+unsigned Task::nOfDestructions { 0 };
+unsigned Task::nOfAssignments { 0 };
+
+void resetTaskCounters() {
+	Task::nOfConstructions = 0;
+	Task::nOfDestructions = 0;
+	Task::nOfAssignments = 0;
+}
+
+struct ByLane {
+	bool operator()(Task const & lhs, Task const & rhs) const {
+		return lhs.lane < rhs.lane;
+	}
+};
+
+struct ArmedByLane {
+	bool operator()(Task const & lhs, Task const & rhs) const {
+		if (armed) {
+			throw std::runtime_error { "comparison failed" };
+		}
+		return lhs.lane < rhs.lane;
+	}
+
+	static bool armed;
+};
+
+bool ArmedByLane::armed { false };
+
+}
+
+void test_pop_returns_largest_element_first() {
+	PriorityBoundedQueue<int> queue { 8 };
+	for (auto element : { 3, 7, 1, 5, 2, 8, 6, 4 }) {
+		queue.push(element);
+	}
+	std::vector<int> popped { };
+	while (!queue.empty()) {
+		popped.push_back(queue.pop());
+	}
+	ASSERT_EQUAL((std::vector<int> { 8, 7, 6, 5, 4, 3, 2, 1 }), popped);
+}
+
+void test_comparator_reverses_order() {
+	PriorityBoundedQueue<int, std::greater<int>> queue { 4 };
+	queue.push(3);
+	queue.push(1);
+	queue.push(2);
+	ASSERT_EQUAL(1, queue.pop());
+	ASSERT_EQUAL(2, queue.pop());
+	ASSERT_EQUAL(3, queue.pop());
+}
+
+void test_equal_priorities_leave_in_push_order() {
+	PriorityBoundedQueue<Task, ByLane> queue { 16 };
+	for (unsigned id { }; id < 12; ++id) {
+		queue.emplace(id % 3, id);
+	}
+	std::vector<unsigned> ids { };
+	while (!queue.empty()) {
+		ids.push_back(queue.pop().id);
+	}
+	ASSERT_EQUAL((std::vector<unsigned> { 2, 5, 8, 11, 1, 4, 7, 10, 0, 3, 6, 9 }), ids);
+}
+
+void test_elements_are_never_default_constructed_or_assigned() {
+	resetTaskCounters();
+	{
+		PriorityBoundedQueue<Task, ByLane> queue { 8 };
+		for (unsigned id { }; id < 8; ++id) {
+			queue.emplace((id * 5) % 8, id);
+		}
+		for (unsigned count { }; count < 4; ++count) {
+			queue.pop();
+		}
+	}
+	ASSERT_EQUAL(0, Task::nOfAssignments);
+	ASSERT_EQUAL(Task::nOfConstructions, Task::nOfDestructions);
+}
+
+void test_try_push_fails_when_full() {
+	PriorityBoundedQueue<int> queue { 2 };
+	ASSERT(queue.try_push(1));
+	ASSERT(queue.try_push(2));
+	ASSERT(!queue.try_push(3));
+	ASSERT(queue.full());
+	ASSERT(!queue.try_push_for(3, std::chrono::milliseconds { 10 }));
+	ASSERT_EQUAL(2, queue.size());
+}
+
+void test_try_push_for_moves_element() {
+	PriorityBoundedQueue<std::unique_ptr<int>> queue { 1 };
+	ASSERT(queue.try_push_for(std::make_unique<int>(42), std::chrono::milliseconds { 10 }));
+	ASSERT_EQUAL(42, *queue.pop());
+}
+
+void test_throwing_comparator_keeps_queue_intact() {
+	resetTaskCounters();
+	{
+		PriorityBoundedQueue<Task, ArmedByLane> queue { 8 };
+		for (unsigned lane { }; lane < 4; ++lane) {
+			queue.push(Task { lane, lane });
+		}
+		ArmedByLane::armed = true;
+		ASSERT_THROWS(queue.push(Task { 7, 4 }), std::runtime_error);
+		ASSERT_EQUAL(4, queue.size());
+		ASSERT_THROWS(queue.pop(), std::runtime_error);
+		ASSERT_EQUAL(3, queue.size());
+		ArmedByLane::armed = false;
+		queue.push(Task { 5, 5 });
+		ASSERT_EQUAL(5, queue.pop().lane);
+		ASSERT_EQUAL(3, queue.size());
+	}
+	ASSERT_EQUAL(Task::nOfConstructions, Task::nOfDestructions);
+}
+
+void test_try_pop_for_times_out_when_empty() {
+	PriorityBoundedQueue<int> queue { 2 };
+	int element { };
+	ASSERT(!queue.try_pop(element));
+	ASSERT(!queue.try_pop_for(element, std::chrono::milliseconds { 10 }));
+}
+
+void test_closed_priority_queue_drains_remaining_elements() {
+	PriorityBoundedQueue<int> queue { 4 };
+	queue.push(1);
+	queue.push(2);
+	queue.close();
+	ASSERT(queue.closed());
+	ASSERT(!queue.try_push(3));
+	ASSERT_THROWS(queue.push(3), queue_closed);
+	ASSERT_EQUAL(2, queue.pop());
+	ASSERT_EQUAL(1, queue.pop());
+	ASSERT_THROWS(queue.pop(), queue_closed);
+}
+
+void test_copy_and_move_keep_elements() {
+	PriorityBoundedQueue<int> queue { 4 };
+	queue.push(1);
+	queue.push(3);
+	queue.push(2);
+	PriorityBoundedQueue<int> copy { queue };
+	PriorityBoundedQueue<int> moved { std::move(queue) };
+	ASSERT_EQUAL(3, copy.pop());
+	ASSERT_EQUAL(3, moved.pop());
+	ASSERT_EQUAL(2, copy.size());
+	ASSERT_EQUAL(2, moved.size());
+	copy = moved;
+	ASSERT_EQUAL(2, copy.pop());
+	ASSERT_EQUAL(1, copy.pop());
+	ASSERT_EQUAL(2, moved.pop());
+}
+
+void test_blocked_consumer_receives_pushed_element() {
+	PriorityBoundedQueue<int> queue { 1 };
+	auto consumer = std::async(std::launch::async, [&] {
+		return queue.pop();
+	});
+	queue.push(42);
+	ASSERT(std::future_status::timeout != consumer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT_EQUAL(42, consumer.get());
+}
+
+void test_producers_and_consumer_exchange_all_elements() {
+	const unsigned nOfElements = 1000;
+	PriorityBoundedQueue<unsigned> queue { 4 };
+	auto producer = [&] (unsigned first) {
+		for (unsigned element { first }; element < nOfElements; element += 2) {
+			queue.push(element);
+		}
+	};
+	auto even = std::async(std::launch::async, producer, 0);
+	auto odd = std::async(std::launch::async, producer, 1);
+	unsigned sum { };
+	for (unsigned count { }; count < nOfElements; ++count) {
+		sum += queue.pop();
+	}
+	even.get();
+	odd.get();
+	ASSERT_EQUAL(nOfElements * (nOfElements - 1) / 2, sum);
+}
+
+cute::suite make_suite_priority_bounded_queue_suite() {
+	cute::suite s { };
+	s.push_back(CUTE(test_pop_returns_largest_element_first));
+	s.push_back(CUTE(test_comparator_reverses_order));
+	s.push_back(CUTE(test_equal_priorities_leave_in_push_order));
+	s.push_back(CUTE(test_elements_are_never_default_constructed_or_assigned));
+	s.push_back(CUTE(test_try_push_fails_when_full));
+	s.push_back(CUTE(test_try_push_for_moves_element));
+	s.push_back(CUTE(test_throwing_comparator_keeps_queue_intact));
+	s.push_back(CUTE(test_try_pop_for_times_out_when_empty));
+	s.push_back(CUTE(test_closed_priority_queue_drains_remaining_elements));
+	s.push_back(CUTE(test_copy_and_move_keep_elements));
+	s.push_back(CUTE(test_blocked_consumer_receives_pushed_element));
+	s.push_back(CUTE(test_producers_and_consumer_exchange_all_elements));
+	return s;
+}
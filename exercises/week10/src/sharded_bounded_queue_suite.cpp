@@ -0,0 +1,183 @@
+#include "sharded_bounded_queue_suite.h"
+
+#include "ShardedBoundedQueue.h"
+#include <cute/cute.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using LockedShardedQueue = ShardedBoundedQueue<unsigned, std::mutex, std::condition_variable, queue_policy::locked>;
+
+void test_sharded_queue_without_shards_throws() {
+	ASSERT_THROWS(ShardedBoundedQueue<unsigned> (4, 0), std::invalid_argument);
+}
+
+void test_sharded_queue_reports_aggregate_capacity_and_size() {
+	ShardedBoundedQueue<unsigned> queue { 4, 3 };
+	ASSERT_EQUAL(3, queue.shards());
+	ASSERT_EQUAL(12, queue.capacity());
+	ASSERT(queue.empty());
+	for (unsigned element { }; element < 6; ++element) {
+		queue.push(element);
+	}
+	ASSERT_EQUAL(6, queue.size());
+	ASSERT(!queue.empty());
+	ASSERT(!queue.full());
+}
+
+template<typename Queue>
+void producer_overflows_into_other_shards() {
+	Queue queue { 2, 3 };
+	for (unsigned element { }; element < 6; ++element) {
+		ASSERT(queue.try_push(element));
+	}
+	ASSERT(queue.full());
+	ASSERT(!queue.try_push(6));
+	ASSERT(!queue.try_push_for(6, std::chrono::milliseconds { 10 }));
+	std::vector<unsigned> popped { };
+	unsigned element { };
+	while (queue.try_pop(element)) {
+		popped.push_back(element);
+	}
+	std::sort(popped.begin(), popped.end());
+	ASSERT_EQUAL((std::vector<unsigned> { 0, 1, 2, 3, 4, 5 }), popped);
+}
+
+void test_producer_overflows_into_other_shards() {
+	producer_overflows_into_other_shards<ShardedBoundedQueue<unsigned>>();
+}
+
+void test_locked_producer_overflows_into_other_shards() {
+	producer_overflows_into_other_shards<LockedShardedQueue>();
+}
+
+void test_consumer_falls_back_to_other_shards() {
+	ShardedBoundedQueue<unsigned> queue { 4, 4 };
+	std::async(std::launch::async, [&] {
+		queue.push(42);
+	}).get();
+	unsigned element { };
+	ASSERT(queue.try_pop(element));
+	ASSERT_EQUAL(42, element);
+	ASSERT(!queue.try_pop_for(element, std::chrono::milliseconds { 10 }));
+}
+
+void test_sharded_queue_elements_are_moved() {
+	ShardedBoundedQueue<std::unique_ptr<unsigned>> queue { 1, 2 };
+	queue.push(std::make_unique<unsigned>(1));
+	queue.push(std::make_unique<unsigned>(2));
+	ASSERT(!queue.try_push(std::make_unique<unsigned>(3)));
+	auto const first = queue.pop();
+	auto const second = queue.pop();
+	ASSERT_EQUAL(3, *first + *second);
+}
+
+void test_blocked_sharded_consumer_wakes_up_for_any_shard() {
+	ShardedBoundedQueue<unsigned> queue { 1, 4 };
+	auto consumer = std::async(std::launch::async, [&] {
+		return queue.pop();
+	});
+	ASSERT(std::future_status::timeout == consumer.wait_for(std::chrono::milliseconds { 10 }));
+	queue.push(7);
+	ASSERT(std::future_status::timeout != consumer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT_EQUAL(7, consumer.get());
+}
+
+void test_blocked_sharded_producer_wakes_up_when_space_is_available() {
+	ShardedBoundedQueue<unsigned> queue { 1, 2 };
+	queue.push(1);
+	queue.push(2);
+	auto producer = std::async(std::launch::async, [&] {
+		queue.push(3);
+	});
+	ASSERT(std::future_status::timeout == producer.wait_for(std::chrono::milliseconds { 10 }));
+	queue.pop();
+	ASSERT(std::future_status::timeout != producer.wait_for(std::chrono::seconds { 1 }));
+	producer.get();
+	ASSERT_EQUAL(2, queue.size());
+}
+
+void test_closed_sharded_queue_drains_remaining_elements() {
+	ShardedBoundedQueue<unsigned> queue { 2, 2 };
+	queue.push(1);
+	queue.push(2);
+	queue.close();
+	ASSERT(queue.closed());
+	ASSERT(!queue.try_push(3));
+	ASSERT_THROWS(queue.push(3), queue_closed);
+	ASSERT_EQUAL(3, queue.pop() + queue.pop());
+	ASSERT_THROWS(queue.pop(), queue_closed);
+}
+
+void test_close_wakes_blocked_sharded_consumer() {
+	ShardedBoundedQueue<unsigned> queue { 1, 2 };
+	auto consumer = std::async(std::launch::async, [&] {
+		return queue.consume([](unsigned) {});
+	});
+	queue.close();
+	ASSERT(std::future_status::timeout != consumer.wait_for(std::chrono::seconds { 1 }));
+	ASSERT(!consumer.get());
+}
+
+template<typename Queue>
+void sharded_workers_exchange_all_elements() {
+	const unsigned nOfElements = 1000;
+	const unsigned nOfThreads = 4;
+	Queue queue { 4, nOfThreads };
+	std::vector<std::future<unsigned>> consumers { };
+	for (unsigned thread { }; thread < nOfThreads; ++thread) {
+		consumers.push_back(std::async(std::launch::async, [&] {
+			unsigned sum { };
+			while (queue.consume([&](unsigned element) { sum += element; })) {
+			}
+			return sum;
+		}));
+	}
+	std::vector<std::future<void>> producers { };
+	for (unsigned thread { }; thread < nOfThreads; ++thread) {
+		producers.push_back(std::async(std::launch::async, [&, thread] {
+			for (unsigned element { thread }; element < nOfElements; element += nOfThreads) {
+				queue.push(element);
+			}
+		}));
+	}
+	for (auto & producer : producers) {
+		producer.get();
+	}
+	queue.close();
+	unsigned sum { };
+	for (auto & consumer : consumers) {
+		sum += consumer.get();
+	}
+	ASSERT_EQUAL(nOfElements * (nOfElements - 1) / 2, sum);
+}
+
+void test_sharded_workers_exchange_all_elements() {
+	sharded_workers_exchange_all_elements<ShardedBoundedQueue<unsigned>>();
+}
+
+void test_locked_sharded_workers_exchange_all_elements() {
+	sharded_workers_exchange_all_elements<LockedShardedQueue>();
+}
+
+cute::suite make_suite_sharded_bounded_queue_suite() {
+	cute::suite s { };
+	s.push_back(CUTE(test_sharded_queue_without_shards_throws));
+	s.push_back(CUTE(test_sharded_queue_reports_aggregate_capacity_and_size));
+	s.push_back(CUTE(test_producer_overflows_into_other_shards));
+	s.push_back(CUTE(test_locked_producer_overflows_into_other_shards));
+	s.push_back(CUTE(test_consumer_falls_back_to_other_shards));
+	s.push_back(CUTE(test_sharded_queue_elements_are_moved));
+	s.push_back(CUTE(test_blocked_sharded_consumer_wakes_up_for_any_shard));
+	s.push_back(CUTE(test_blocked_sharded_producer_wakes_up_when_space_is_available));
+	s.push_back(CUTE(test_closed_sharded_queue_drains_remaining_elements));
+	s.push_back(CUTE(test_close_wakes_blocked_sharded_consumer));
+	s.push_back(CUTE(test_sharded_workers_exchange_all_elements));
+	s.push_back(CUTE(test_locked_sharded_workers_exchange_all_elements));
+	return s;
+}
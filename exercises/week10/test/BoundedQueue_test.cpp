@@ -7,6 +7,8 @@
 //@CMAKE_CUTE_DEPENDENCY=exercises/week10/src/bounded_queue_signatures_suite.cpp
 //@CMAKE_CUTE_DEPENDENCY=exercises/week10/src/bounded_queue_single_threaded_lock_suite.cpp
 //@CMAKE_CUTE_DEPENDENCY=exercises/week10/src/bounded_queue_student_suite.cpp
+//@CMAKE_CUTE_DEPENDENCY=exercises/week10/src/priority_bounded_queue_suite.cpp
+//@CMAKE_CUTE_DEPENDENCY=exercises/week10/src/sharded_bounded_queue_suite.cpp
 
 #include "bounded_queue_signatures_suite.h"
 #include "bounded_queue_default_behavior_suite.h"
@@ -17,6 +19,8 @@
 #include "bounded_queue_non_default_constructible_element_type_suite.h"
 #include "bounded_queue_single_threaded_lock_suite.h"
 #include "bounded_queue_multi_threaded_suite.h"
+#include "priority_bounded_queue_suite.h"
+#include "sharded_bounded_queue_suite.h"
 
 #include <cute/cute.h>
 #include <cute/ide_listener.h>
@@ -42,6 +46,8 @@ auto runAllTests(int argc, char const *argv[]){
 	success &= cute::makeRunner(lis,argc,argv)(make_suite_bounded_queue_non_default_constructible_element_type_suite(), "BoundedQueue Non-Default-Constructible Element Type Tests");
 	success &= cute::makeRunner(lis,argc,argv)(make_suite_bounded_queue_single_threaded_lock_suite(), "BoundedQueue Single Threaded Lock Tests");
 	success &= cute::makeRunner(lis,argc,argv)(make_suite_bounded_queue_multi_threaded_suite(), "BoundedQueue Multi-Threaded Tests");
+	success &= cute::makeRunner(lis,argc,argv)(make_suite_priority_bounded_queue_suite(), "PriorityBoundedQueue Tests");
+	success &= cute::makeRunner(lis,argc,argv)(make_suite_sharded_bounded_queue_suite(), "ShardedBoundedQueue Tests");
 
   return success;
 }